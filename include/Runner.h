@@ -2,10 +2,14 @@
 
 #include <memory>
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include <stdexcept>
 #include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
@@ -13,28 +17,21 @@
 #include "market_connection/Admin.h"
 #include "market_connection/Feeder.h"
 #include "market_connection/Broker.h"
+#include "market_connection/LegPipeline.h"
+#include "market_connection/AssetLockTable.h"
 #include "market_connection/OrderBook.h"
+#include "market_connection/UpdateEventRing.h"
+#include "market_connection/DepthBook.h"
+#include "market_connection/ReplayFeeder.h"
 #include "crypto/ed25519.hpp"
+#include "common/SpscRing.h"
 
 #include "strategies/TriangularArbitrage.h"
 #include "fin/SymbolFilters.h"
 #include "fin/OrderSizer.h"
 #include "fin/Symbol.h"
 #include "persistence/TradePersistence.h"
-
-// Exception thrown when arbitrage execution fails mid-way
-class ArbitrageExecutionError : public std::runtime_error {
-public:
-    ArbitrageExecutionError(const std::string& msg, int failedLeg, const std::string& orderId)
-        : std::runtime_error(msg), failedLeg_(failedLeg), orderId_(orderId) {}
-
-    int failedLeg() const { return failedLeg_; }
-    const std::string& orderId() const { return orderId_; }
-
-private:
-    int failedLeg_;
-    std::string orderId_;
-};
+#include "persistence/RouteCache.h"
 
 /**
  * Polling mode for the main loop.
@@ -42,7 +39,16 @@ private:
 enum class PollingMode {
     Blocking,     // Use condition variable (lower CPU, higher latency)
     BusyPoll,     // Spin with pause hints (higher CPU, lower latency)
-    Hybrid        // Spin for N iterations, then block
+    Hybrid,       // Spin for N iterations, then block
+    EventQueue    // Consume ordered per-symbol events (spin, then park)
+};
+
+/**
+ * How the legs of a signal are sent.
+ */
+enum class ExecutionMode {
+    Sequential,   // Each leg sized from the previous fill
+    Parallel      // All legs at once when the inventory covers every leg's input asset
 };
 
 struct RunnerConfig {
@@ -51,9 +57,11 @@ struct RunnerConfig {
     int fixMdPort = 9000;
     std::string fixOeEndpoint;
     int fixOePort = 9000;
+    int marketDepth = 1;  // > 1 subscribes to the depth stream and enables VWAP pricing
 
     // REST API settings
     std::string restEndpoint = "testnet.binance.vision";
+    int exchangeInfoRefreshSec = 0;  // 0 = exchange info is only read at startup
 
     // Authentication
     std::string apiKey;
@@ -61,14 +69,26 @@ struct RunnerConfig {
 
     // Execution settings
     bool liveMode = false;
+    ExecutionMode executionMode = ExecutionMode::Sequential;
+    double rebalanceThreshold = 0.25;  // Parallel mode: drift (fraction of target inventory) that triggers a rebalance
     PollingMode pollingMode = PollingMode::Hybrid;
     int busyPollSpinCount = 10000;
+    size_t eventRingCapacity = 65536;  // EventQueue mode only (rounded up to power of two)
+    size_t maxConcurrentArbitrages = 4; // In flight at once, on disjoint assets
 
     // Persistence settings
     std::string tradeLogDir = "./trades";
+    std::string routeCacheFile;  // Empty = always parse exchange info and discover routes
+
+    // Replay settings (non-empty journal = offline replay, no FIX sessions)
+    std::string replayJournal;
+    double replaySpeed = 0.0;           // 0 = max, 1 = real time, N = N times real time
+    double replayBalance = 1000.0;      // Simulated balance per starting asset
+    std::map<std::string, double> replayBalances;  // Per-asset overrides
+    std::string replayExchangeInfoFile; // Saved exchangeInfo JSON, REST fetch if empty
 
-    // Strategy config (nested)
-    TriangularArbitrageConfig strategyConfig;
+    // One strategy instance per starting asset, all over the same book
+    std::vector<TriangularArbitrageConfig> strategyConfigs;
 };
 
 /**
@@ -83,7 +103,7 @@ struct RunnerConfig {
 class Runner {
 public:
     explicit Runner(const RunnerConfig& config);
-    ~Runner() = default;
+    ~Runner();
 
     void initialize();
     void shutdown();
@@ -109,25 +129,201 @@ private:
     std::unique_ptr<crypto::ed25519> key_;
     std::unique_ptr<Admin> admin_;
     OrderBook orderBook_;
+    std::unique_ptr<UpdateEventRing> eventRing_;  // EventQueue mode only
+    std::unique_ptr<DepthBook> depthBook_;        // marketDepth > 1 only
     std::unique_ptr<Feeder> feeder_;
+    std::unique_ptr<ReplayFeeder> replayFeeder_;  // Replay mode only (replaces feeder_)
     std::unique_ptr<Broker> broker_;
+    std::unique_ptr<LegPipelinePool> pipelines_;  // Driven by broker_'s execution reports
 
-    // Strategy
-    std::unique_ptr<TriangularArbitrage> strategy_;
+    // Strategies, one per starting asset (config order = dedupe priority)
+    std::vector<std::unique_ptr<TriangularArbitrage>> strategies_;
 
     // Persistence
     std::unique_ptr<TradePersistence> tradePersistence_;
 
     // State
-    std::map<std::string, double> balance_;
+    std::map<std::string, double> balance_;  // Execution thread once running
     std::vector<fin::Symbol> symbolsList_;
     OrderSizer orderSizer_;
+    UpdateMask subscribedMask_;  // Full re-screen set after event ring overflow
 
     // Shutdown flag
     std::atomic<bool> shutdownRequested_{false};
 
+    /**
+     * Everything derived from one exchange-info snapshot. The refresher
+     * builds a complete generation off the hot path; the detection thread
+     * adopts it by swapping pointers between two ticks (RCU-style: nothing
+     * is mutated in place). The replaced state goes back through
+     * retiredGenerations_ and is freed by the refresher, never on the
+     * detection thread.
+     */
+    struct StrategyGeneration {
+        std::vector<std::unique_ptr<TriangularArbitrage>> strategies;
+        std::vector<fin::Symbol> symbols;
+        OrderSizer orderSizer;
+        UpdateMask subscribedMask;
+    };
+
+    // Exchange-info refresher (live mode, exchangeInfoRefreshSec > 0)
+    std::unique_ptr<Admin> refreshAdmin_;  // Own REST client, the main one is not shared
+    std::thread refreshThread_;
+    std::mutex refreshMtx_;
+    std::condition_variable refreshCv_;
+    bool refreshStop_ = false;
+    uint64_t refreshKey_ = 0;                       // RouteCache::computeKey of the last snapshot
+    std::set<std::string> refreshSymbols_;          // Listed symbols in the last snapshot
+    std::set<std::string> refreshSubscribed_;       // Symbols subscribed so far
+    std::atomic<StrategyGeneration*> pendingGeneration_{nullptr};  // Built, not yet adopted
+    // Replaced generations, detection thread -> refresher (drained at each refresh and in ~Runner)
+    static constexpr size_t RETIRED_QUEUE_CAPACITY = 8;
+    SpscRing<StrategyGeneration*> retiredGenerations_{RETIRED_QUEUE_CAPACITY};
+    std::vector<std::unique_ptr<StrategyGeneration>> unreturnedGenerations_;  // Queue was full; detection thread
+    void freeRetiredGenerations();
+
+    std::vector<std::unique_ptr<TriangularArbitrage>> createStrategies() const;
+    void startExchangeInfoRefresh(uint64_t key, std::set<std::string> subscribed);
+    void stopExchangeInfoRefresh();
+    void refreshLoop();
+    void refreshExchangeInfo();
+
+    /**
+     * Detection thread: install a pending generation if there is one.
+     * Returns true when the strategies changed (caller re-screens).
+     */
+    bool adoptPendingGeneration();
+
     void waitForMarketDataSnapshots();
-    void executeArbitrage(const Signal& signal);
+    void runEventQueue();
+    void runReplay();
+
+    /**
+     * Signal turned into legs on the detection thread (fees and filters are
+     * resolved there, against the strategies it owns), executed on the
+     * execution thread.
+     */
+    struct PlannedArbitrage {
+        std::string startingAsset;
+        std::string description;
+        double pnl = 0.0;
+        std::vector<PlannedLeg> legs;
+        std::vector<std::string> assets;  // Every asset of the cycle (asset locks)
+        uint64_t detectTsc = 0;
+    };
+
+    // Detection -> execution hand-off; owning pointers, freed by the consumer
+    static constexpr size_t SIGNAL_QUEUE_CAPACITY = 64;
+    std::unique_ptr<SpscRing<PlannedArbitrage*>> signalQueue_;
+    std::thread executionThread_;
+    std::atomic<bool> executionStop_{false};
+
+    /**
+     * Stake source for the detection thread: balance_ per starting asset,
+     * republished by the execution thread whenever balance_ changes.
+     */
+    std::map<std::string, std::atomic<double>> publishedBalance_;
+    void publishBalances();
+
+    /**
+     * Held while strategies_, symbolsList_ and orderSizer_ are swapped; the
+     * execution thread takes it to read them (rebalance planning).
+     */
+    std::mutex generationMtx_;
+
+    /**
+     * Detection thread: plan the signal and queue it for execution (run
+     * inline in replay, where there is no execution thread).
+     */
+    void submitSignal(const Signal& signal);
+    std::unique_ptr<PlannedArbitrage> planArbitrage(const Signal& signal);
+
+    void startExecutionThread();
+    void stopExecutionThread();
+    void executionLoop();
+
+    /**
+     * Execution thread: start the arbitrage on an idle pipeline once its
+     * assets are locked; dropped (stale) when none is idle or an asset is
+     * held by an arbitrage in flight.
+     */
+    void executeArbitrage(PlannedArbitrage& arbitrage);
+
+    /**
+     * Execution thread: persist and report every finished arbitrage, or
+     * start rolling it back on its own pipeline, and release its assets
+     * once nothing is left in flight for it. Never throws: an error fails
+     * the slot and execution (see executionFailed_), the other slots are
+     * still collected.
+     */
+    void collectExecution();
+    void finishArbitrage(size_t slot, const PipelineResult& result);
+
+    /**
+     * Set by the first failed arbitrage or execution error (execution
+     * thread, or the replay loop). No new signal is started from then on;
+     * every pipeline is collected, failed ones rolled back, and shutdown
+     * is requested once all of them are idle.
+     */
+    bool executionFailed_ = false;
+
+    // Context of the arbitrage in flight on each pipeline (execution thread)
+    struct InFlightArbitrage {
+        std::string startingAsset;
+        std::string description;
+        double pnl = 0.0;
+        double balanceBefore = 0.0;  // Starting asset balance when it was sent
+        bool parallel = false;
+        bool rebalance = false;      // Inventory rebalance order, not an arbitrage
+        std::vector<std::string> assets;  // Locked in assetLocks_ until it finishes
+    };
+    std::vector<InFlightArbitrage> inFlight_;
+
+    // Rollback of a failed arbitrage in flight on each pipeline (execution thread)
+    struct InFlightRollback {
+        std::vector<PlannedLeg> legs;  // Reversing orders still to send, the next one last
+        int retries = 0;               // Of the order in flight
+        bool complete = true;          // No order given up so far
+    };
+    std::vector<InFlightRollback> rollbacks_;
+    AssetLockTable assetLocks_;
+
+    /**
+     * Parallel mode: inventory per asset at startup, and whether the last
+     * parallel arbitrage or rebalance may have left drift to correct.
+     */
+    std::map<std::string, double> inventoryTarget_;
+    bool rebalanceDue_ = false;
+
+    /**
+     * True when balance_ holds every leg's input asset (with headroom).
+     */
+    bool inventoryCovers(const PlannedArbitrage& arbitrage) const;
+
+    /**
+     * Send one market order on an idle pipeline that moves the first
+     * drifted, unlocked asset back towards its target, against a starting
+     * asset. Execution thread, under generationMtx_; both assets are locked
+     * while the order is in flight.
+     */
+    void rebalanceInventory();
+    std::optional<PlannedLeg> planRebalanceLeg(const std::string& asset, double drift,
+                                               std::string& counterAsset) const;
+    void finishRebalance(const PipelineResult& result);
+
+    /**
+     * Stake of one instance: risk * balance of its starting asset.
+     */
+    double stakeFor(const TriangularArbitrage& strategy) const;
+    bool hasTradableBalance() const;
+    TriangularArbitrage& strategyFor(const std::string& startingAsset);
+
+    /**
+     * Run every instance on the update and keep the signal with the best
+     * return on stake (pnl is in each instance's own starting asset).
+     */
+    std::optional<Signal> detectUpdates(const UpdateMask& updatedSymbols);
+    std::optional<Signal> detectSymbol(SymbolId symbolId);
 
     // Execution result tracking
     struct LegResult {
@@ -140,25 +336,16 @@ private:
         double feeRate;
     };
 
-    // Executed order tracking for rollback purposes
-    struct ExecutedOrder {
-        std::string clOrdId;
-        std::string symbol;
-        char side;              // '1' = BUY, '2' = SELL
-        double filledQty;       // Actual filled quantity
-        double avgPrice;        // Average fill price
-    };
-
-    void handleExecutionFailure(int legIndex, const std::string& clOrdId, const std::string& reason,
-                                const std::vector<ExecutedOrder>& executedOrders);
-
     /**
-     * Execute rollback orders for previously successful legs.
-     * For each executed order, sends the opposite order (BUY -> SELL, SELL -> BUY)
-     * using the actual filled quantity.
-     *
-     * @param executedOrders Vector of orders that were successfully executed
-     * @return true if all rollback orders succeeded, false if any failed
+     * Rollback of a failed arbitrage, on the pipeline it ran on: one
+     * opposite market order per filled leg (BUY -> SELL, SELL -> BUY) for
+     * the filled quantity, last leg first, each sent once the previous one
+     * has settled so the other pipelines keep being collected meanwhile.
      */
-    bool executeRollback(const std::vector<ExecutedOrder>& executedOrders);
+    static constexpr int ROLLBACK_TIMEOUT_MS = 10000;  // Longer timeout for rollback orders
+    static constexpr int MAX_ROLLBACK_RETRIES = 1;     // Only retry once to avoid infinite loops
+
+    void handleExecutionFailure(size_t slot, const PipelineResult& result, std::vector<PlannedLeg> rollbackLegs);
+    void sendRollbackLeg(size_t slot);
+    void finishRollbackLeg(size_t slot, const PipelineResult& result);
 };
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * SpscRing - Bounded single-producer/single-consumer queue.
+ *
+ * Design:
+ * - Power-of-two capacity, free-running 64-bit head/tail counters
+ * - Producer and consumer indices on separate cache lines
+ * - Each side caches the other side's index to avoid cross-core reads
+ *   on every operation
+ * - tryPush never blocks: a full ring is reported to the caller
+ *
+ * Thread safety: exactly one producer thread and one consumer thread.
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements must be trivially copyable");
+
+public:
+    explicit SpscRing(size_t capacity)
+        : buffer_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity))
+        , mask_(buffer_.size() - 1)
+    {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Producer side. Returns false if the ring is full.
+     */
+    bool tryPush(const T& value) noexcept {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) [[unlikely]] {
+                return false;
+            }
+        }
+        buffer_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Returns false if the ring is empty.
+     */
+    bool tryPop(T& out) noexcept {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        out = buffer_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return buffer_.size(); }
+
+private:
+    std::vector<T> buffer_;
+    const uint64_t mask_;
+
+    // Consumer-owned
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t cachedTail_ = 0;
+
+    // Producer-owned
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint64_t cachedHead_ = 0;
+};
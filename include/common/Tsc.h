@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
+
+/**
+ * Cheap receive timestamp for hot-path tagging.
+ * Raw TSC ticks on x86-64, steady_clock nanoseconds elsewhere.
+ */
+inline uint64_t readTsc() noexcept {
+#ifdef __x86_64__
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
@@ -3,6 +3,8 @@
 #include <string>
 #include <map>
 #include <array>
+#include <memory>
+#include <span>
 #include <optional>
 #include <stdexcept>
 #include "fin/SymbolFilters.h"
@@ -39,6 +41,15 @@ struct AdjustedOrder {
     OrderValidationResult validation;
 };
 
+/**
+ * LegSize - One leg for the batched SymbolId APIs
+ */
+struct LegSize {
+    SymbolId id = INVALID_SYMBOL_ID;
+    double price = 0;
+    double quantity = 0;
+};
+
 /**
  * OrderSizer - Validates and adjusts orders to meet exchange filter requirements
  *
@@ -68,8 +79,9 @@ public:
         // Also populate the SymbolId-indexed array for O(1) lookups
         SymbolId id = SymbolRegistry::instance().getId(symbol);
         if (id != INVALID_SYMBOL_ID) {
-            filtersBySymbolId_[id] = &filters_[symbol];
-            hasFiltersBySymbolId_[id] = true;
+            table_->filters[id] = &filters_[symbol];
+            table_->hasFilters[id] = true;
+            fillTable(id, filters);
         }
 
         LOG_DEBUG("[OrderSizer] Added {}: lotStep={}, lotPrec={}, mktStep={}, mktPrec={}",
@@ -287,8 +299,7 @@ public:
      */
     void clear() {
         filters_.clear();
-        filtersBySymbolId_.fill(nullptr);
-        hasFiltersBySymbolId_.fill(false);
+        table_ = std::make_unique<RoundingTable>();
     }
 
     // Fast-path methods using SymbolId for O(1) lookups
@@ -297,31 +308,104 @@ public:
      * Check if symbol is registered (by SymbolId)
      */
     [[nodiscard]] bool hasSymbol(SymbolId id) const noexcept {
-        return hasFiltersBySymbolId_[id];
+        return table_->hasFilters[id];
     }
 
     /**
      * Round quantity using SymbolId for O(1) lookup
      */
     [[nodiscard]] double roundQuantity(SymbolId id, double quantity, bool isMarketOrder = false) const {
-        const auto* filters = filtersBySymbolId_[id];
-        if (!filters) {
+        const RoundingTable& table = *table_;
+        if (!table.hasFilters[id]) {
             return quantity;
         }
-        return isMarketOrder ? filters->roundMarketQty(quantity) : filters->roundQty(quantity);
+        const size_t set = isMarketOrder;
+        return Filters::fromUnits(Filters::roundUnits(Filters::toUnits(quantity),
+            table.stepUnits[set][id], table.minUnits[set][id], table.maxUnits[set][id]));
+    }
+
+    /**
+     * Round the quantity of every leg in place (unknown symbols untouched)
+     */
+    void roundQuantities(std::span<LegSize> legs, bool isMarketOrder = false) const noexcept {
+        for (auto& leg : legs) {
+            leg.quantity = roundQuantity(leg.id, leg.quantity, isMarketOrder);
+        }
+    }
+
+    /**
+     * True when price * quantity of every leg is within its NOTIONAL
+     * (or MIN_NOTIONAL) bounds; unknown symbols pass
+     */
+    [[nodiscard]] bool validateNotionals(std::span<const LegSize> legs, bool isMarketOrder = false) const noexcept {
+        const size_t set = isMarketOrder;
+        const RoundingTable& table = *table_;
+        bool valid = true;
+        for (const auto& leg : legs) {
+            const double notional = leg.price * leg.quantity;
+            const double minNotional = table.minNotional[set][leg.id];
+            const double maxNotional = table.maxNotional[set][leg.id];
+            valid &= (minNotional <= 0 || notional >= minNotional)
+                   & (maxNotional <= 0 || notional <= maxNotional);
+        }
+        return valid;
     }
 
     /**
      * Get filters for a symbol (by SymbolId)
      */
     [[nodiscard]] const SymbolFilters* getFilters(SymbolId id) const noexcept {
-        return filtersBySymbolId_[id];
+        return table_->filters[id];
     }
 
 private:
-    std::map<std::string, SymbolFilters> filters_;
+    /**
+     * Hot constants of every symbol, one dense array per field indexed by
+     * SymbolId: the fast path reads these instead of the ~400-byte
+     * SymbolFilters. Set [0] is for limit orders (LOT_SIZE), set [1] for
+     * market orders (MARKET_LOT_SIZE, falling back to LOT_SIZE).
+     * Quantities in fixed-point units; 0 = no bound.
+     *
+     * About 360 KB with the per-id filter pointers, so it lives on the
+     * heap: clear() and swapping two sizers (generation adoption) are
+     * pointer operations, never a copy or a stack temporary.
+     */
+    template <typename T>
+    using PerOrderType = std::array<std::array<T, MAX_SYMBOLS>, 2>;
+
+    struct RoundingTable {
+        std::array<const SymbolFilters*, MAX_SYMBOLS> filters{};  // Into filters_ (stable map nodes)
+        std::array<bool, MAX_SYMBOLS> hasFilters{};
+        PerOrderType<int64_t> stepUnits{};
+        PerOrderType<int64_t> minUnits{};
+        PerOrderType<int64_t> maxUnits{};
+        PerOrderType<double> minNotional{};
+        PerOrderType<double> maxNotional{};
+    };
+
+    void fillTable(SymbolId id, const SymbolFilters& filters) {
+        const auto& lot = filters.lotSize();
+        const auto& market = filters.marketLotSize();
+        for (size_t set = 0; set < 2; ++set) {
+            const bool useMarket = set == 1 && market.isValid();
+            table_->stepUnits[set][id] = useMarket ? market.stepUnits : lot.stepUnits;
+            table_->minUnits[set][id] = useMarket ? market.minUnits : lot.minUnits;
+            table_->maxUnits[set][id] = useMarket ? market.maxUnits : lot.maxUnits;
+
+            // Mirrors SymbolFilters::validateNotional: NOTIONAL wins over MIN_NOTIONAL
+            const auto& notional = filters.notional();
+            const auto& minNotional = filters.minNotional();
+            const bool isMarket = set == 1;
+            if (notional.isValid()) {
+                table_->minNotional[set][id] = !isMarket || notional.applyMinToMarket ? notional.minNotional : 0.0;
+                table_->maxNotional[set][id] = !isMarket || notional.applyMaxToMarket ? notional.maxNotional : 0.0;
+            } else {
+                table_->minNotional[set][id] = !isMarket || minNotional.applyToMarket ? minNotional.minNotional : 0.0;
+                table_->maxNotional[set][id] = 0.0;
+            }
+        }
+    }
 
-    // Parallel arrays indexed by SymbolId for O(1) lookups
-    std::array<const SymbolFilters*, MAX_SYMBOLS> filtersBySymbolId_{};
-    std::array<bool, MAX_SYMBOLS> hasFiltersBySymbolId_{};
+    std::map<std::string, SymbolFilters> filters_;
+    std::unique_ptr<RoundingTable> table_ = std::make_unique<RoundingTable>();
 };
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <optional>
 #include <stdexcept>
@@ -8,6 +11,66 @@
 
 namespace Filters {
 
+/**
+ * Fixed-point units: quantities and prices as int64 multiples of 1e-8, the
+ * finest step and tick the exchange publishes. Steps and ticks are parsed
+ * into units exactly from their decimal strings, so rounding to a step is
+ * an integer division and never leaves a floating-point residue.
+ */
+constexpr int64_t FIXED_SCALE = 100'000'000;
+constexpr double FIXED_SCALE_D = 1e8;
+
+/**
+ * Double to units, truncated. The 1e-12 relative slack absorbs binary
+ * representation error (0.3 * 1e8 = 29999999.999999996); clamped to
+ * [0, 9e18] so the conversion cannot overflow.
+ */
+inline int64_t toUnits(double value) noexcept {
+    const double scaled = value * FIXED_SCALE_D;
+    const double slack = std::floor(scaled + std::abs(scaled) * 1e-12);
+    return static_cast<int64_t>(std::min(9e18, std::max(0.0, slack)));
+}
+
+inline double fromUnits(int64_t units) noexcept {
+    return static_cast<double>(units) / FIXED_SCALE_D;
+}
+
+/**
+ * Exact decimal text of units (non-negative), trailing zeros trimmed:
+ * 120000 -> "0.0012". `out` needs UNITS_TEXT_SIZE chars; returns the length.
+ */
+constexpr size_t UNITS_TEXT_SIZE = 32;
+
+inline size_t formatUnits(int64_t units, char* out) noexcept {
+    char* end = std::to_chars(out, out + UNITS_TEXT_SIZE, units / FIXED_SCALE).ptr;
+    int64_t fraction = units % FIXED_SCALE;
+    if (fraction == 0) {
+        return static_cast<size_t>(end - out);
+    }
+
+    int digits = 8;
+    while (fraction % 10 == 0) {
+        fraction /= 10;
+        --digits;
+    }
+    *end++ = '.';
+    for (int i = digits - 1; i >= 0; --i, fraction /= 10) {
+        end[i] = static_cast<char>('0' + fraction % 10);
+    }
+    return static_cast<size_t>(end + digits - out);
+}
+
+/**
+ * Round down to a multiple of step and clamp to [minUnits, maxUnits]
+ * (0 = no bound on either side, or no step).
+ */
+inline int64_t roundUnits(int64_t units, int64_t step, int64_t minUnits, int64_t maxUnits) noexcept {
+    if (step > 0) units -= units % step;
+    if (minUnits > 0) units = std::max(minUnits, units);
+    if (maxUnits > 0) units = std::min(maxUnits, units);
+    return units;
+}
+
 /**
  * PRICE_FILTER - Defines price rules for a symbol
  * - minPrice: minimum price allowed (disabled if 0)
@@ -20,26 +83,21 @@ struct PriceFilter {
     double tickSize = 0;
     int precision = 0;
 
+    // Same bounds in fixed-point units, filled by SymbolFilters::fromJson
+    int64_t minPriceUnits = 0;
+    int64_t maxPriceUnits = 0;
+    int64_t tickUnits = 0;
+
     bool isValid() const { return tickSize > 0 || minPrice > 0 || maxPrice > 0; }
 
     double roundPrice(double price) const {
-        double rounded = price;
-        if (tickSize > 0) {
-            rounded = std::floor(price / tickSize) * tickSize;
-        }
-        // Always apply precision truncation (default to 8 decimals if precision not set)
-        int effectivePrecision = (tickSize > 0) ? precision : 8;
-        double mult = std::pow(10.0, effectivePrecision);
-        rounded = std::floor(rounded * mult + 1e-9) / mult;
-        if (minPrice > 0) rounded = std::max(minPrice, rounded);
-        if (maxPrice > 0) rounded = std::min(maxPrice, rounded);
-        return rounded;
+        return fromUnits(roundUnits(toUnits(price), tickUnits, minPriceUnits, maxPriceUnits));
     }
 
     bool validatePrice(double price) const {
         if (minPrice > 0 && price < minPrice) return false;
         if (maxPrice > 0 && price > maxPrice) return false;
-        if (tickSize > 0 && std::fmod(price, tickSize) > 1e-10) return false;
+        if (tickUnits > 0 && toUnits(price) % tickUnits != 0) return false;
         return true;
     }
 };
@@ -56,26 +114,26 @@ struct LotSizeFilter {
     double stepSize = 0;
     int precision = 0;
 
+    // Same bounds in fixed-point units, filled by SymbolFilters::fromJson
+    int64_t minUnits = 0;
+    int64_t maxUnits = 0;
+    int64_t stepUnits = 0;
+
     bool isValid() const { return stepSize > 0 || minQty > 0 || maxQty > 0; }
 
     double roundQty(double qty) const {
-        double rounded = qty;
-        if (stepSize > 0) {
-            rounded = std::floor(qty / stepSize) * stepSize;
-        }
-        // Always apply precision truncation (default to 8 decimals if precision not set)
-        int effectivePrecision = (stepSize > 0) ? precision : 8;
-        double mult = std::pow(10.0, effectivePrecision);
-        rounded = std::floor(rounded * mult + 1e-9) / mult;
-        if (minQty > 0) rounded = std::max(minQty, rounded);
-        if (maxQty > 0) rounded = std::min(maxQty, rounded);
-        return rounded;
+        return fromUnits(roundUnits(toUnits(qty), stepUnits, minUnits, maxUnits));
+    }
+
+    // Round down to the step without lifting to minQty
+    double floorQty(double qty) const {
+        return fromUnits(roundUnits(toUnits(qty), stepUnits, 0, maxUnits));
     }
 
     bool validateQty(double qty) const {
         if (minQty > 0 && qty < minQty) return false;
         if (maxQty > 0 && qty > maxQty) return false;
-        if (stepSize > 0 && std::fmod(qty, stepSize) > 1e-10) return false;
+        if (stepUnits > 0 && toUnits(qty) % stepUnits != 0) return false;
         return true;
     }
 };
@@ -89,26 +147,26 @@ struct MarketLotSizeFilter {
     double stepSize = 0;
     int precision = 0;
 
+    // Same bounds in fixed-point units, filled by SymbolFilters::fromJson
+    int64_t minUnits = 0;
+    int64_t maxUnits = 0;
+    int64_t stepUnits = 0;
+
     bool isValid() const { return stepSize > 0 || minQty > 0 || maxQty > 0; }
 
     double roundQty(double qty) const {
-        double rounded = qty;
-        if (stepSize > 0) {
-            rounded = std::floor(qty / stepSize) * stepSize;
-        }
-        // Always apply precision truncation (default to 8 decimals if precision not set)
-        int effectivePrecision = (stepSize > 0) ? precision : 8;
-        double mult = std::pow(10.0, effectivePrecision);
-        rounded = std::floor(rounded * mult + 1e-9) / mult;
-        if (minQty > 0) rounded = std::max(minQty, rounded);
-        if (maxQty > 0) rounded = std::min(maxQty, rounded);
-        return rounded;
+        return fromUnits(roundUnits(toUnits(qty), stepUnits, minUnits, maxUnits));
+    }
+
+    // Round down to the step without lifting to minQty
+    double floorQty(double qty) const {
+        return fromUnits(roundUnits(toUnits(qty), stepUnits, 0, maxUnits));
     }
 
     bool validateQty(double qty) const {
         if (minQty > 0 && qty < minQty) return false;
         if (maxQty > 0 && qty > maxQty) return false;
-        if (stepSize > 0 && std::fmod(qty, stepSize) > 1e-10) return false;
+        if (stepUnits > 0 && toUnits(qty) % stepUnits != 0) return false;
         return true;
     }
 };
@@ -346,6 +404,13 @@ public:
     double roundMarketQty(double qty) const {
         return marketLotSize_.isValid() ? marketLotSize_.roundQty(qty) : lotSize_.roundQty(qty);
     }
+    // What an amount covers: may be below minMarketQty(), never lifted to it
+    double floorMarketQty(double qty) const {
+        return marketLotSize_.isValid() ? marketLotSize_.floorQty(qty) : lotSize_.floorQty(qty);
+    }
+    double minMarketQty() const {
+        return marketLotSize_.isValid() ? marketLotSize_.minQty : lotSize_.minQty;
+    }
 
     // Price precision (number of decimal places)
     int pricePrecision() const { return priceFilter_.precision; }
@@ -21,6 +21,18 @@ public:
     // Fetch all tradeable symbols with their filters
     std::vector<fin::Symbol> fetchExchangeInfo();
 
+    // Raw /api/v3/exchangeInfo response (route cache keys on it before parsing)
+    nlohmann::json fetchExchangeInfoJson();
+
+    // Read a saved /api/v3/exchangeInfo JSON response
+    static nlohmann::json readExchangeInfoFile(const std::string& path);
+
+    // Load a saved /api/v3/exchangeInfo JSON response (offline replay)
+    static std::vector<fin::Symbol> loadExchangeInfoFile(const std::string& path);
+
+    // Extract TRADING symbols and filters from an exchangeInfo response
+    static std::vector<fin::Symbol> parseExchangeInfo(const nlohmann::json& response);
+
     // Fetch account balances (non-zero only)
     std::map<std::string, double> fetchAccountBalances();
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * AssetLockTable - Assets held by the arbitrages in flight.
+ *
+ * A cycle starts only if none of its assets is held, so arbitrages that
+ * run concurrently never spend or receive the same balance. Cycles of one
+ * starting asset always share it and stay serialised; cycles of different
+ * starting assets with disjoint intermediates run side by side.
+ *
+ * Execution thread only.
+ */
+class AssetLockTable {
+public:
+    /**
+     * Lock every asset, or none if one of them is already held.
+     */
+    bool tryLock(const std::vector<std::string>& assets) {
+        for (const auto& asset : assets) {
+            if (locked_.count(asset) != 0) {
+                return false;
+            }
+        }
+        locked_.insert(assets.begin(), assets.end());
+        return true;
+    }
+
+    void unlock(const std::vector<std::string>& assets) {
+        for (const auto& asset : assets) {
+            locked_.erase(asset);
+        }
+    }
+
+    [[nodiscard]] bool isLocked(const std::string& asset) const { return locked_.count(asset) != 0; }
+    [[nodiscard]] size_t size() const noexcept { return locked_.size(); }
+
+private:
+    std::unordered_set<std::string> locked_;
+};
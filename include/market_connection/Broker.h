@@ -2,11 +2,14 @@
 
 #include <fix/Broker.hpp>
 #include <fix/types/OrderTypes.hpp>
-#include <map>
-#include <mutex>
-#include <condition_variable>
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "market_connection/OrderSlotRing.h"
+#include "market_connection/OrderBook.h"
 
 // Use libxchange OrderStatus type
 using OrderStatus = BNB::FIX::OrderStatus;
@@ -24,20 +27,57 @@ struct OrderState {
     std::string rejectReason;
 };
 
+/**
+ * OrderListener - Told about every order that reaches a final status
+ * (FILLED, CANCELED, REJECTED, EXPIRED), on the thread that saw it: the
+ * FIX callback thread, or the sending thread for simulated orders.
+ */
+class OrderListener {
+public:
+    virtual ~OrderListener() = default;
+    virtual void onOrderDone(const OrderState& state) = 0;
+};
+
 // Broker handles FIX-based order execution:
 // - Market orders (live and test mode)
-// - Order state tracking
+// - Order state tracking (OrderSlotRing, keyed by the clOrdId sequence)
 // - Execution reports
 // - Session-level Reject handling
 class Broker : public BNB::FIX::Broker {
 public:
     Broker(const std::string& apiKey, crypto::ed25519& key, bool liveMode = false);
-    virtual ~Broker() = default;
+    virtual ~Broker();
 
     std::string sendMarketOrder(const std::string& symbol, char side, double qty, double estPrice = 0.0);
     std::string testMarketOrder(const std::string& symbol, char side, double qty, double estPrice = 0.0);
 
+    /**
+     * Send under a caller-chosen clOrdId (from newClOrdId()), so the caller
+     * can record it before the execution report can possibly arrive. Uses
+     * the order template of (symbolId, side) when there is one.
+     */
+    void sendMarketOrder(const std::string& clOrdId, SymbolId symbolId, const std::string& symbol, char side,
+                         double qty, double estPrice = 0.0);
+
+    /**
+     * Build a NewSingleOrder per (symbol, side) up front, so that a send
+     * only patches ClOrdID and OrderQty. Symbols already prepared are
+     * skipped; any thread, typically when routes are (re)discovered.
+     */
+    void prepareOrderTemplates(const std::vector<std::string>& symbols);
+    std::string newClOrdId() { return generateClOrdId(); }
+
+    /**
+     * Listener for final order states; nullptr to detach.
+     */
+    void setOrderListener(OrderListener* listener) { listener_.store(listener, std::memory_order_release); }
+
     OrderState getOrderState(const std::string& clOrdId);
+
+    /**
+     * Wait on this order's own slot (spin, then short sleeps) for a final
+     * status; UNKNOWN on timeout. Other orders' reports do not wake it.
+     */
     OrderStatus waitForOrderCompletion(const std::string& clOrdId, int timeoutMs = 5000);
 
     bool isLiveMode() const { return liveMode_; }
@@ -50,12 +90,20 @@ protected:
 private:
     std::string generateClOrdId();
     void handleReject(const FIX::Message& message);
+    void fillTestOrder(const std::string& clOrdId, const std::string& symbol, char side, double qty, double estPrice);
+    void notifyDone(const OrderState& state);
+    OrderState snapshot(const OrderSlot& slot, const std::string& clOrdId) const;
+
+    OrderSlotRing orderSlots_;
+
+    // Prototype message reused in place; `inUse` guards the rare concurrent send
+    struct OrderTemplate;
+    std::unique_ptr<std::atomic<OrderTemplate*>[]> templates_;  // [symbolId * 2 + isSell]
+    std::vector<std::unique_ptr<OrderTemplate>> templateStore_;  // Owns them, under templateMtx_
+    std::mutex templateMtx_;
 
-    std::map<std::string, OrderState> orderStates_;
-    mutable std::mutex orderMtx_;
-    std::condition_variable orderCv_;
+    std::atomic<OrderListener*> listener_{nullptr};
 
-    std::atomic<int> orderIdCounter_{0};
     bool liveMode_ = false;
 
     // Track pending order clOrdId for reject correlation
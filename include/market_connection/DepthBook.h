@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "market_connection/OrderBook.h"
+
+constexpr int MAX_DEPTH_LEVELS = 20;
+
+struct DepthLevel {
+    double price = 0.0;
+    double qty = 0.0;
+};
+
+enum class BookSide : uint8_t {
+    Bid = 0,
+    Ask = 1
+};
+
+/**
+ * DepthSnapshot - Consistent reader-side copy of one symbol's levels.
+ * Bids are sorted best (highest) first, asks best (lowest) first.
+ */
+struct DepthSnapshot {
+    std::array<DepthLevel, MAX_DEPTH_LEVELS> bids{};
+    std::array<DepthLevel, MAX_DEPTH_LEVELS> asks{};
+    uint8_t bidCount = 0;
+    uint8_t askCount = 0;
+};
+
+/**
+ * DepthBook - Depth-N L2 book for every symbol, stored in flat arrays.
+ *
+ * Design:
+ * - Levels for (SymbolId, side) live at a fixed offset in one flat array
+ * - Per-symbol SeqLock, same protocol as OrderBook
+ * - Single writer (FIX thread) applies snapshots and incremental refreshes
+ * - Levels beyond the configured depth are dropped
+ *
+ * Thread safety: one writer, any number of wait-free readers.
+ */
+class DepthBook {
+public:
+    explicit DepthBook(int depth = MAX_DEPTH_LEVELS)
+        : depth_(static_cast<uint8_t>(std::clamp(depth, 1, MAX_DEPTH_LEVELS)))
+        , levels_(MAX_SYMBOLS * 2 * MAX_DEPTH_LEVELS)
+        , counts_(MAX_SYMBOLS * 2, 0)
+        , sequences_(MAX_SYMBOLS)
+    {
+    }
+
+    DepthBook(const DepthBook&) = delete;
+    DepthBook& operator=(const DepthBook&) = delete;
+
+    [[nodiscard]] int depth() const noexcept { return depth_; }
+
+    // ---- Writer side (FIX thread) ----
+
+    void beginUpdate(SymbolId id) noexcept {
+        auto& seq = sequences_[id];
+        seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endUpdate(SymbolId id) noexcept {
+        std::atomic_thread_fence(std::memory_order_release);
+        auto& seq = sequences_[id];
+        seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * Remove all levels on both sides (start of a full snapshot).
+     * Must be called between beginUpdate/endUpdate.
+     */
+    void clear(SymbolId id) noexcept {
+        counts_[sideIndex(id, BookSide::Bid)] = 0;
+        counts_[sideIndex(id, BookSide::Ask)] = 0;
+    }
+
+    /**
+     * Insert, replace or (qty <= 0) delete the level at `price`.
+     * Must be called between beginUpdate/endUpdate.
+     */
+    void applyLevel(SymbolId id, BookSide side, double price, double qty) noexcept {
+        if (price <= 0.0) [[unlikely]] {
+            return;
+        }
+
+        const size_t si = sideIndex(id, side);
+        DepthLevel* levels = &levels_[si * MAX_DEPTH_LEVELS];
+        uint8_t& count = counts_[si];
+
+        // Find insertion point: bids descending, asks ascending
+        uint8_t pos = 0;
+        while (pos < count && isBetter(side, levels[pos].price, price)) {
+            ++pos;
+        }
+
+        const bool exists = pos < count && levels[pos].price == price;
+
+        if (qty <= 0.0) {
+            if (exists) {
+                std::copy(levels + pos + 1, levels + count, levels + pos);
+                --count;
+            }
+            return;
+        }
+
+        if (exists) {
+            levels[pos].qty = qty;
+            return;
+        }
+
+        if (pos >= depth_) {
+            return;  // Worse than the deepest level we keep
+        }
+
+        const uint8_t newCount = std::min<uint8_t>(count + 1, depth_);
+        std::copy_backward(levels + pos, levels + newCount - 1, levels + newCount);
+        levels[pos] = {price, qty};
+        count = newCount;
+    }
+
+    // ---- Reader side (wait-free) ----
+
+    /**
+     * Copy one symbol's levels. Returns false if either side is empty.
+     */
+    bool read(SymbolId id, DepthSnapshot& out) const noexcept {
+        const auto& seq = sequences_[id];
+        const size_t bi = sideIndex(id, BookSide::Bid);
+        const size_t ai = sideIndex(id, BookSide::Ask);
+        uint64_t seq1, seq2;
+
+        do {
+            seq1 = seq.load(std::memory_order_acquire);
+
+            if (seq1 & 1) {
+#ifdef __x86_64__
+                _mm_pause();
+#endif
+                continue;
+            }
+
+            out.bidCount = counts_[bi];
+            out.askCount = counts_[ai];
+            std::copy_n(&levels_[bi * MAX_DEPTH_LEVELS], out.bidCount, out.bids.begin());
+            std::copy_n(&levels_[ai * MAX_DEPTH_LEVELS], out.askCount, out.asks.begin());
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seq2 = seq.load(std::memory_order_acquire);
+        } while (seq1 != seq2);
+
+        return out.bidCount > 0 && out.askCount > 0;
+    }
+
+private:
+    uint8_t depth_;
+    std::vector<DepthLevel> levels_;                 // [SymbolId][side][level]
+    std::vector<uint8_t> counts_;                    // [SymbolId][side]
+    std::vector<std::atomic<uint64_t>> sequences_;   // [SymbolId]
+
+    static size_t sideIndex(SymbolId id, BookSide side) noexcept {
+        return static_cast<size_t>(id) * 2 + static_cast<size_t>(side);
+    }
+
+    static bool isBetter(BookSide side, double levelPrice, double price) noexcept {
+        return side == BookSide::Bid ? levelPrice > price : levelPrice < price;
+    }
+};
@@ -11,6 +11,9 @@
 
 #include "fin/Symbol.h"
 #include "market_connection/OrderBook.h"
+#include "market_connection/UpdateEventRing.h"
+#include "market_connection/DepthBook.h"
+#include "persistence/MarketDataJournal.h"
 
 // Use libxchange SymbolInfo type
 using SymbolInfo = BNB::FIX::SymbolInfo;
@@ -36,6 +39,25 @@ public:
     std::vector<SymbolInfo> getSymbols();
     void waitForInstrumentList();
 
+    /**
+     * Optional ordered event stream, written alongside the OrderBook.
+     * Must be set before connect(); the Feeder does not own the ring.
+     */
+    void setEventRing(UpdateEventRing* ring) { eventRing_ = ring; }
+
+    /**
+     * Optional depth-N book maintained from the FIX depth stream.
+     * When set (depth > 1), subscribeToSymbols() also subscribes to depth.
+     * Must be set before subscribing; the Feeder does not own the book.
+     */
+    void setDepthBook(DepthBook* depthBook) { depthBook_ = depthBook; }
+
+    /**
+     * Optional binary journal: every snapshot and incremental top-of-book
+     * update is appended as a fixed-size record. Not owned.
+     */
+    void setJournal(MarketDataJournal* journal) { journal_ = journal; }
+
 protected:
     void onMessage(const FIX44::MD::InstrumentList& message, const FIX::SessionID& sessionID) override;
     void onMessage(const FIX44::MD::MarketDataSnapshot& message, const FIX::SessionID& sessionID) override;
@@ -44,6 +66,9 @@ protected:
 
 private:
     OrderBook& orderBook_;
+    UpdateEventRing* eventRing_ = nullptr;
+    DepthBook* depthBook_ = nullptr;
+    MarketDataJournal* journal_ = nullptr;
 
     // Pre-computed symbol ID cache for O(1) lookup in hot path
     std::unordered_map<std::string, SymbolId> symbolIdCache_;
@@ -69,4 +94,18 @@ private:
 
     // Get or create symbol ID (with caching)
     SymbolId getOrCreateSymbolId(const std::string& symbol);
+
+    // Write one top-of-book change to the OrderBook (and event ring if attached)
+    void applyQuote(SymbolId symbolId, double bid, double ask,
+                    double bidQty, double askQty, uint64_t recvTsc);
+
+    void recordQuote(JournalRecordType type, SymbolId symbolId, const std::string& symbol,
+                     const BNB::FIX::MarketDataUpdate& update, uint64_t recvTimeNs, uint64_t exchTimeNs);
+
+    // Depth stream handling
+    template <typename Message>
+    bool isDepthMessage(const Message& message) const;
+
+    template <typename Message>
+    void applyDepthEntries(const Message& message, bool isSnapshot);
 };
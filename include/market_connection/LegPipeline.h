@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "market_connection/Broker.h"
+#include "fin/Order.h"
+#include "fin/SymbolFilters.h"
+
+/**
+ * One leg as planned from the signal.
+ */
+struct PlannedLeg {
+    std::string symbol;
+    SymbolId symbolId;      // Picks the Broker's order template
+    Way way;
+    char side;              // FIX side, '1' = BUY, '2' = SELL
+    double estPrice;
+    double qty;             // Signal quantity; legs 2+ are re-sized from the previous fill
+    double feeRate;         // Decimal, e.g. 0.001
+    SymbolFilters filters;  // Own copy: the FIX thread never touches shared sizing state
+};
+
+/**
+ * One leg as executed (filledQty may be partial on failure, 0 when the
+ * leg was never sent or did not fill).
+ */
+struct LegFill {
+    std::string clOrdId;
+    double sentQty = 0.0;
+    double filledQty = 0.0;
+    double avgPrice = 0.0;
+};
+
+/**
+ * Outcome of one arbitrage, handed back to the execution thread.
+ */
+struct PipelineResult {
+    std::vector<PlannedLeg> legs;
+    std::vector<LegFill> fills;   // One per leg, same order
+    bool failed = false;
+    int failedLeg = -1;
+    std::string failedClOrdId;
+    std::string reason;
+};
+
+/**
+ * LegPipeline - Event-driven leg execution.
+ *
+ * start() sends leg 1 and returns. Each final execution report arrives in
+ * onOrderDone() on the FIX callback thread, which sizes the next leg from
+ * the actual cumQty/avgPx and sends it right there: no thread handoff and
+ * no wake-up between legs. The execution thread keeps taking signals
+ * and collects the outcome with poll().
+ *
+ * Parallel runs send every leg at once (the inventory already holds each
+ * leg's input asset) and finish when all legs have reported; the first
+ * failing leg is the one reported.
+ *
+ * One arbitrage in flight per pipeline. A leg without a final report after
+ * LEG_TIMEOUT_MS (or the timeout given to start()) is failed by poll(); a
+ * late report for it is ignored.
+ */
+class LegPipeline : public OrderListener {
+public:
+    static constexpr int LEG_TIMEOUT_MS = 5000;
+
+    explicit LegPipeline(Broker& broker);
+
+    /**
+     * Send leg 1, or every leg when `parallel`; each leg fails after
+     * `timeoutMs` without a final report. False (nothing sent) while an
+     * arbitrage is in flight.
+     */
+    bool start(std::vector<PlannedLeg> legs, bool parallel = false, int timeoutMs = LEG_TIMEOUT_MS);
+
+    [[nodiscard]] bool busy() const noexcept {
+        return state_.load(std::memory_order_acquire) != State::Idle;
+    }
+
+    /**
+     * Execution thread: the finished arbitrage, if any; also applies the
+     * leg timeout. Cheap when idle.
+     */
+    std::optional<PipelineResult> poll() {
+        if (state_.load(std::memory_order_acquire) == State::Idle) [[likely]] {
+            return std::nullopt;
+        }
+        return collect();
+    }
+
+    void onOrderDone(const OrderState& state) override;
+
+private:
+    enum class State : uint8_t { Idle, Running, Done };
+
+    Broker& broker_;
+    std::atomic<State> state_{State::Idle};
+
+    std::mutex mtx_;
+    PipelineResult result_;
+    bool parallel_ = false;
+    int timeoutMs_ = LEG_TIMEOUT_MS;
+    std::vector<std::string> pendingClOrdIds_;  // Per leg, empty once it reported
+    size_t pending_ = 0;                        // Legs sent and not yet reported
+    std::chrono::steady_clock::time_point deadline_;
+
+    std::optional<PipelineResult> collect();
+
+    // Under mtx_; the first failure is the one kept
+    void recordFailure(size_t leg, const std::string& clOrdId, const std::string& reason);
+    void finish();
+
+    /**
+     * Under mtx_: pick the clOrdId of a leg and arm the timeout. The caller
+     * sends after unlocking (simulated fills re-enter onOrderDone).
+     */
+    std::string armLeg(size_t leg);
+};
+
+/**
+ * LegPipelinePool - Fixed set of pipelines behind one Broker listener, one
+ * arbitrage in flight per pipeline. Every report is offered to each
+ * pipeline; a pipeline ignores clOrdIds it did not send.
+ */
+class LegPipelinePool : public OrderListener {
+public:
+    LegPipelinePool(Broker& broker, size_t size) {
+        const size_t count = std::max<size_t>(size, 1);
+        pipelines_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            pipelines_.push_back(std::make_unique<LegPipeline>(broker));
+        }
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return pipelines_.size(); }
+    [[nodiscard]] LegPipeline& operator[](size_t index) noexcept { return *pipelines_[index]; }
+
+    /**
+     * Index of an idle pipeline, size() when all are busy.
+     */
+    [[nodiscard]] size_t findIdle() const noexcept {
+        size_t index = 0;
+        while (index < pipelines_.size() && pipelines_[index]->busy()) {
+            ++index;
+        }
+        return index;
+    }
+
+    [[nodiscard]] bool anyBusy() const noexcept {
+        for (const auto& pipeline : pipelines_) {
+            if (pipeline->busy()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void onOrderDone(const OrderState& state) override {
+        for (auto& pipeline : pipelines_) {
+            pipeline->onOrderDone(state);
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<LegPipeline>> pipelines_;
+};
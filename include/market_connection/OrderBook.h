@@ -2,8 +2,9 @@
 
 #include <atomic>
 #include <array>
-#include <bitset>
+#include <bit>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <mutex>
 #include <condition_variable>
@@ -19,17 +20,51 @@
 using SymbolId = uint16_t;
 constexpr SymbolId INVALID_SYMBOL_ID = UINT16_MAX;
 constexpr size_t MAX_SYMBOLS = 4096;
+constexpr size_t UPDATE_MASK_WORDS = MAX_SYMBOLS / 64;
+static_assert(UPDATE_MASK_WORDS <= 64, "Dirty summary word must cover all mask words");
 
 struct BidAsk {
     double bid = 0.0;
     double ask = 0.0;
+    double bidQty = 0.0;  // Size at best bid (0 = unknown)
+    double askQty = 0.0;  // Size at best ask (0 = unknown)
+};
+
+/**
+ * UpdateMask - Plain (non-atomic) set of symbol IDs drained from the OrderBook.
+ *
+ * Two-level layout: one bit per symbol in `words`, one bit per non-empty
+ * word in `summary`, so empty checks are O(1).
+ */
+struct UpdateMask {
+    uint64_t summary = 0;
+    std::array<uint64_t, UPDATE_MASK_WORDS> words{};
+
+    [[nodiscard]] bool test(size_t id) const noexcept {
+        return (words[id >> 6] >> (id & 63)) & 1ULL;
+    }
+
+    void set(size_t id) noexcept {
+        words[id >> 6] |= 1ULL << (id & 63);
+        summary |= 1ULL << (id >> 6);
+    }
+
+    [[nodiscard]] bool none() const noexcept { return summary == 0; }
+    [[nodiscard]] bool any() const noexcept { return summary != 0; }
+
+    void reset() noexcept {
+        summary = 0;
+        words.fill(0);
+    }
 };
 
 /**
  * SymbolRegistry - Maps symbol strings to dense integer IDs for O(1) lookups.
  *
- * Thread safety: Registration is NOT thread-safe (done at initialization).
- * Lookups are thread-safe and lock-free after initialization.
+ * Thread safety: name lookups and registration take a mutex (the exchange
+ * info refresher registers new listings at runtime). IDs are never reused
+ * and slots never move (reserved to MAX_SYMBOLS), so getSymbol(id) stays
+ * lock-free for any id handed out earlier.
  */
 class SymbolRegistry {
 public:
@@ -42,6 +77,7 @@ public:
     SymbolRegistry& operator=(const SymbolRegistry&) = delete;
 
     SymbolId registerSymbol(const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mtx_);
         auto it = symbolToId_.find(symbol);
         if (it != symbolToId_.end()) {
             return it->second;
@@ -71,19 +107,23 @@ public:
     }
 
     [[nodiscard]] SymbolId getId(const std::string& symbol) const {
+        std::lock_guard<std::mutex> lock(mtx_);
         auto it = symbolToId_.find(symbol);
         return (it != symbolToId_.end()) ? it->second : INVALID_SYMBOL_ID;
     }
 
     [[nodiscard]] bool hasSymbol(const std::string& symbol) const {
+        std::lock_guard<std::mutex> lock(mtx_);
         return symbolToId_.find(symbol) != symbolToId_.end();
     }
 
-    [[nodiscard]] size_t size() const noexcept {
+    [[nodiscard]] size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx_);
         return idToSymbol_.size();
     }
 
     void clear() {
+        std::lock_guard<std::mutex> lock(mtx_);
         symbolToId_.clear();
         idToSymbol_.clear();
     }
@@ -93,18 +133,21 @@ private:
         idToSymbol_.reserve(MAX_SYMBOLS);
     }
 
+    mutable std::mutex mtx_;
     std::unordered_map<std::string, SymbolId> symbolToId_;
     std::vector<std::string> idToSymbol_;
 };
 
 /**
- * Cache-line aligned atomic price slot with sequence lock.
+ * Cache-line aligned atomic top-of-book slot (prices + sizes) with sequence lock.
  */
 struct alignas(64) AtomicPriceSlot {
     std::atomic<uint64_t> sequence{0};
     double bid{0.0};
     double ask{0.0};
-    char padding_[64 - sizeof(std::atomic<uint64_t>) - 2 * sizeof(double)];
+    double bidQty{0.0};
+    double askQty{0.0};
+    char padding_[64 - sizeof(std::atomic<uint64_t>) - 4 * sizeof(double)];
 
     AtomicPriceSlot() = default;
     AtomicPriceSlot(const AtomicPriceSlot&) = delete;
@@ -112,6 +155,13 @@ struct alignas(64) AtomicPriceSlot {
 };
 static_assert(sizeof(AtomicPriceSlot) == 64, "AtomicPriceSlot must be cache-line sized");
 
+// Slot layout in doubles, for vector gathers straight from the slot array
+constexpr int32_t PRICE_SLOT_STRIDE = sizeof(AtomicPriceSlot) / sizeof(double);
+constexpr int32_t PRICE_SLOT_BID_OFFSET = 1;
+constexpr int32_t PRICE_SLOT_ASK_OFFSET = 2;
+static_assert(offsetof(AtomicPriceSlot, bid) == PRICE_SLOT_BID_OFFSET * sizeof(double));
+static_assert(offsetof(AtomicPriceSlot, ask) == PRICE_SLOT_ASK_OFFSET * sizeof(double));
+
 /**
  * OrderBook - High-performance price storage using SeqLock pattern.
  *
@@ -121,24 +171,41 @@ static_assert(sizeof(AtomicPriceSlot) == 64, "AtomicPriceSlot must be cache-line
  * - Readers retry if sequence changed (torn read detection)
  * - No locks on read path
  *
+ * Update signalling:
+ * - Dirty set is a two-level atomic bitset (word array + summary word)
+ * - Writers fetch_or their bit, consumers drain with exchange (no mutex)
+ * - Kernel wake-up only when the consumer is actually parked
+ *
  * Performance:
  * - Write: ~10-30ns
  * - Read: ~5-20ns (wait-free)
  */
 class OrderBook {
 public:
-    OrderBook() {
-        updatedBits_.reset();
-    }
+    OrderBook() = default;
 
     /**
      * Update by symbol ID (hot path - preferred).
-     * Only updates non-zero values to handle partial updates (bid-only or ask-only).
+     * Only updates non-zero prices to handle partial updates (bid-only or ask-only);
+     * a side's quantity is written together with its price.
+     */
+    void update(SymbolId id, double bid, double ask,
+                double bidQty = 0.0, double askQty = 0.0) noexcept {
+        if (storeQuote(id, bid, ask, bidQty, askQty)) {
+            markUpdated(id);
+        }
+    }
+
+    /**
+     * Seqlocked write without signalling consumers.
+     * Pair with markUpdated() when something must be published in between
+     * (e.g. an UpdateEventRing entry). Returns false if nothing was written.
      */
-    void update(SymbolId id, double bid, double ask) noexcept {
+    bool storeQuote(SymbolId id, double bid, double ask,
+                    double bidQty = 0.0, double askQty = 0.0) noexcept {
         // Skip if both values are zero (no actual update)
         if (bid == 0.0 && ask == 0.0) {
-            return;
+            return false;
         }
 
         auto& slot = data_[id];
@@ -151,30 +218,40 @@ public:
         // Only update non-zero values
         if (bid > 0.0) {
             slot.bid = bid;
+            slot.bidQty = bidQty;
         }
         if (ask > 0.0) {
             slot.ask = ask;
+            slot.askQty = askQty;
         }
 
         std::atomic_thread_fence(std::memory_order_release);
         slot.sequence.store(seq + 2, std::memory_order_release);
+        return true;
+    }
 
-        // Set atomic flag BEFORE acquiring mutex for lock-free fast-path
-        hasUpdatesAtomic_.store(true, std::memory_order_release);
-        {
-            std::lock_guard<std::mutex> lock(updateMtx_);
-            updatedBits_.set(id);
-            hasUpdates_ = true;
+    /**
+     * Add a symbol to the dirty set and wake the consumer if it is parked.
+     */
+    void markUpdated(SymbolId id) noexcept {
+        dirtyWords_[id >> 6].fetch_or(1ULL << (id & 63), std::memory_order_release);
+        // seq_cst pairs with parkUntilDirty(): either we see the parked flag
+        // or the consumer sees our summary bit before sleeping.
+        dirtySummary_.fetch_or(1ULL << (id >> 6), std::memory_order_seq_cst);
+
+        if (consumerParked_.load(std::memory_order_seq_cst)) [[unlikely]] {
+            { std::lock_guard<std::mutex> lock(parkMtx_); }
+            parkCv_.notify_one();
         }
-        updateCv_.notify_one();
     }
 
     /**
      * Update by symbol string (convenience - registers symbol if needed).
      */
-    void update(const std::string& symbol, double bid, double ask) {
+    void update(const std::string& symbol, double bid, double ask,
+                double bidQty = 0.0, double askQty = 0.0) {
         SymbolId id = SymbolRegistry::instance().registerSymbol(symbol);
-        update(id, bid, ask);
+        update(id, bid, ask, bidQty, askQty);
     }
 
     /**
@@ -197,6 +274,8 @@ public:
 
             result.bid = slot.bid;
             result.ask = slot.ask;
+            result.bidQty = slot.bidQty;
+            result.askQty = slot.askQty;
 
             std::atomic_thread_fence(std::memory_order_acquire);
             seq2 = slot.sequence.load(std::memory_order_acquire);
@@ -211,7 +290,7 @@ public:
     [[nodiscard]] BidAsk get(const std::string& symbol) const {
         SymbolId id = SymbolRegistry::instance().getId(symbol);
         if (id == INVALID_SYMBOL_ID) {
-            return {0.0, 0.0};
+            return {};
         }
         return get(id);
     }
@@ -232,54 +311,50 @@ public:
     }
 
     /**
-     * Wait for updates, returns bitmap of updated symbols.
+     * Raw view of the slot array as doubles (see PRICE_SLOT_* offsets).
+     * Reads through it bypass the seqlock: a bid/ask pair may straddle two
+     * updates. Only for screening passes whose hits are re-read with get().
      */
-    std::bitset<MAX_SYMBOLS> waitForUpdates() {
-        std::unique_lock<std::mutex> lock(updateMtx_);
-        updateCv_.wait(lock, [this] { return hasUpdates_; });
-
-        std::bitset<MAX_SYMBOLS> result = updatedBits_;
-        updatedBits_.reset();
-        hasUpdates_ = false;
-        hasUpdatesAtomic_.store(false, std::memory_order_release);
+    [[nodiscard]] const double* rawPrices() const noexcept {
+        return reinterpret_cast<const double*>(data_.data());
+    }
+
+    /**
+     * Wait for updates, returns mask of updated symbols.
+     */
+    UpdateMask waitForUpdates() {
+        UpdateMask result;
+        while (!drainUpdates(result)) {
+            parkUntilDirty(std::chrono::steady_clock::time_point::max());
+        }
         return result;
     }
 
     /**
      * Wait for updates with timeout for periodic shutdown checks.
-     * Returns empty bitset on timeout.
+     * Returns empty mask on timeout.
      */
-    std::bitset<MAX_SYMBOLS> waitForUpdatesWithTimeout(std::chrono::milliseconds timeout) {
-        std::unique_lock<std::mutex> lock(updateMtx_);
-        bool gotUpdate = updateCv_.wait_for(lock, timeout, [this] { return hasUpdates_; });
-
-        if (!gotUpdate) {
-            return std::bitset<MAX_SYMBOLS>();  // Timeout - return empty
+    UpdateMask waitForUpdatesWithTimeout(std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        UpdateMask result;
+        while (!drainUpdates(result)) {
+            if (!parkUntilDirty(deadline)) {
+                drainUpdates(result);
+                break;  // Timeout - result is empty unless an update raced in
+            }
         }
-
-        std::bitset<MAX_SYMBOLS> result = updatedBits_;
-        updatedBits_.reset();
-        hasUpdates_ = false;
-        hasUpdatesAtomic_.store(false, std::memory_order_release);
         return result;
     }
 
     /**
      * Busy-poll for updates with spin limit.
-     * Uses lock-free atomic check to avoid mutex acquisition on every iteration.
+     * Polls the summary word only; never touches the park mutex while spinning.
      */
-    std::bitset<MAX_SYMBOLS> waitForUpdatesSpin(int maxSpins = 10000) {
+    UpdateMask waitForUpdatesSpin(int maxSpins = 10000) {
+        UpdateMask result;
         for (int i = 0; i < maxSpins; ++i) {
-            // Fast-path: check atomic without lock
-            if (hasUpdatesAtomic_.load(std::memory_order_acquire)) {
-                std::lock_guard<std::mutex> lock(updateMtx_);
-                if (hasUpdates_) {
-                    std::bitset<MAX_SYMBOLS> result = updatedBits_;
-                    updatedBits_.reset();
-                    hasUpdates_ = false;
-                    hasUpdatesAtomic_.store(false, std::memory_order_release);
-                    return result;
-                }
+            if (dirtySummary_.load(std::memory_order_relaxed) != 0 && drainUpdates(result)) {
+                return result;
             }
 #ifdef __x86_64__
             _mm_pause();
@@ -291,22 +366,34 @@ public:
     /**
      * Non-blocking check for updates.
      */
-    std::bitset<MAX_SYMBOLS> consumeUpdates() {
-        std::lock_guard<std::mutex> lock(updateMtx_);
-        if (!hasUpdates_) {
-            return std::bitset<MAX_SYMBOLS>();
-        }
-
-        std::bitset<MAX_SYMBOLS> result = updatedBits_;
-        updatedBits_.reset();
-        hasUpdates_ = false;
-        hasUpdatesAtomic_.store(false, std::memory_order_release);
+    UpdateMask consumeUpdates() {
+        UpdateMask result;
+        drainUpdates(result);
         return result;
     }
 
-    [[nodiscard]] bool hasUpdates() const {
-        std::lock_guard<std::mutex> lock(updateMtx_);
-        return hasUpdates_;
+    /**
+     * Drain the dirty set into `out` (overwritten). Lock-free.
+     * Returns true if at least one symbol was drained.
+     */
+    bool drainUpdates(UpdateMask& out) noexcept {
+        out.reset();
+        uint64_t summary = dirtySummary_.exchange(0, std::memory_order_acq_rel);
+        while (summary != 0) {
+            const unsigned w = static_cast<unsigned>(std::countr_zero(summary));
+            summary &= summary - 1;
+
+            const uint64_t bits = dirtyWords_[w].exchange(0, std::memory_order_acq_rel);
+            if (bits != 0) {
+                out.words[w] = bits;
+                out.summary |= 1ULL << w;
+            }
+        }
+        return out.any();
+    }
+
+    [[nodiscard]] bool hasUpdates() const noexcept {
+        return dirtySummary_.load(std::memory_order_acquire) != 0;
     }
 
     [[nodiscard]] size_t size() const {
@@ -316,9 +403,33 @@ public:
 private:
     std::array<AtomicPriceSlot, MAX_SYMBOLS> data_{};
 
-    mutable std::mutex updateMtx_;
-    std::condition_variable updateCv_;
-    std::bitset<MAX_SYMBOLS> updatedBits_;
-    bool hasUpdates_ = false;
-    std::atomic<bool> hasUpdatesAtomic_{false};  // Lock-free fast-path check
+    // Lock-free dirty set: producer side is fetch_or only
+    alignas(64) std::array<std::atomic<uint64_t>, UPDATE_MASK_WORDS> dirtyWords_{};
+    alignas(64) std::atomic<uint64_t> dirtySummary_{0};
+
+    // Park/wake path - only used when the consumer is asleep
+    alignas(64) std::atomic<bool> consumerParked_{false};
+    std::mutex parkMtx_;
+    std::condition_variable parkCv_;
+
+    /**
+     * Sleep until the dirty set is non-empty or the deadline passes.
+     * Returns false on timeout.
+     */
+    bool parkUntilDirty(std::chrono::steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(parkMtx_);
+        consumerParked_.store(true, std::memory_order_seq_cst);
+        auto dirty = [this] { return dirtySummary_.load(std::memory_order_seq_cst) != 0; };
+
+        bool ready;
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            parkCv_.wait(lock, dirty);
+            ready = true;
+        } else {
+            ready = parkCv_.wait_until(lock, deadline, dirty);
+        }
+
+        consumerParked_.store(false, std::memory_order_relaxed);
+        return ready;
+    }
 };
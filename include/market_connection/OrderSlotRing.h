@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <fix/types/OrderTypes.hpp>
+
+/**
+ * OrderSlot - State of one order, in a preallocated slot.
+ *
+ * The first cache line holds what a fill touches; names and texts follow.
+ * `status` is stored last with release: once it is final, every other
+ * field is complete and no longer written (later reports are dropped).
+ */
+struct alignas(64) OrderSlot {
+    static constexpr size_t SYMBOL_SIZE = 32;
+    static constexpr size_t ORDER_ID_SIZE = 32;
+    static constexpr size_t TEXT_SIZE = 128;
+
+    std::atomic<uint64_t> seq{0};  // clOrdId sequence owning the slot, 0 = never used
+    std::atomic<BNB::FIX::OrderStatus> status{BNB::FIX::OrderStatus::UNKNOWN};
+    char side = 0;
+    std::atomic<double> orderQty{0.0};
+    std::atomic<double> cumQty{0.0};
+    std::atomic<double> cumCost{0.0};  // Cumulative cost for avgPx calculation
+    std::atomic<double> avgPx{0.0};
+
+    char symbol[SYMBOL_SIZE] = {};
+    char orderId[ORDER_ID_SIZE] = {};
+    char rejectReason[TEXT_SIZE] = {};
+
+    [[nodiscard]] static bool isFinal(BNB::FIX::OrderStatus status) noexcept {
+        return status == BNB::FIX::OrderStatus::FILLED ||
+               status == BNB::FIX::OrderStatus::CANCELED ||
+               status == BNB::FIX::OrderStatus::REJECTED ||
+               status == BNB::FIX::OrderStatus::EXPIRED;
+    }
+
+    // Truncating copy, always NUL-terminated
+    template <size_t N>
+    static void copyText(char (&dst)[N], std::string_view text) noexcept {
+        const size_t size = text.size() < N ? text.size() : N - 1;
+        std::memcpy(dst, text.data(), size);
+        dst[size] = '\0';
+    }
+};
+
+/**
+ * OrderSlotRing - Order states indexed by the sequence number carried in
+ * the clOrdId ("<prefix><seq>"), no map and no lock.
+ *
+ * A sequence owns slot `seq % CAPACITY` until CAPACITY newer orders have
+ * been sent; a report for an order that old no longer matches the slot's
+ * seq and is dropped. Fixed footprint: nothing grows over a trading day.
+ *
+ * Thread safety: claim() from any sending thread (sequences are unique),
+ * reports from the FIX callback thread, reads from anywhere.
+ */
+class OrderSlotRing {
+public:
+    static constexpr size_t CAPACITY = 4096;
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "OrderSlotRing capacity must be a power of two");
+
+    explicit OrderSlotRing(std::string prefix)
+        : prefix_(std::move(prefix))
+    {
+    }
+
+    OrderSlotRing(const OrderSlotRing&) = delete;
+    OrderSlotRing& operator=(const OrderSlotRing&) = delete;
+
+    [[nodiscard]] uint64_t nextSeq() noexcept { return nextSeq_.fetch_add(1, std::memory_order_relaxed); }
+
+    [[nodiscard]] std::string clOrdId(uint64_t seq) const {
+        char digits[20];
+        std::string id(prefix_);
+        id.append(digits, std::to_chars(digits, digits + sizeof(digits), seq).ptr);
+        return id;
+    }
+
+    /**
+     * Sequence carried by a clOrdId of this ring, 0 for any other clOrdId.
+     * A prefix compare and an integer parse, no hashing.
+     */
+    [[nodiscard]] uint64_t parseSeq(std::string_view clOrdId) const noexcept {
+        if (clOrdId.size() <= prefix_.size() || clOrdId.compare(0, prefix_.size(), prefix_) != 0) {
+            return 0;
+        }
+        uint64_t seq = 0;
+        const char* last = clOrdId.data() + clOrdId.size();
+        auto [ptr, ec] = std::from_chars(clOrdId.data() + prefix_.size(), last, seq);
+        return (ec == std::errc() && ptr == last) ? seq : 0;
+    }
+
+    /**
+     * Reset the slot of `seq` for a new order. False when the previous
+     * owner never reached a final status (it is overwritten all the same).
+     */
+    bool claim(uint64_t seq, std::string_view symbol, char side, double qty,
+               BNB::FIX::OrderStatus status) noexcept {
+        OrderSlot& slot = slots_[seq & MASK];
+        const bool wasFinal = slot.seq.load(std::memory_order_relaxed) == 0 ||
+                              OrderSlot::isFinal(slot.status.load(std::memory_order_relaxed));
+
+        slot.seq.store(0, std::memory_order_relaxed);  // Reports for the old owner stop matching
+        slot.side = side;
+        slot.orderQty.store(qty, std::memory_order_relaxed);
+        slot.cumQty.store(0.0, std::memory_order_relaxed);
+        slot.cumCost.store(0.0, std::memory_order_relaxed);
+        slot.avgPx.store(0.0, std::memory_order_relaxed);
+        OrderSlot::copyText(slot.symbol, symbol);
+        slot.orderId[0] = '\0';
+        slot.rejectReason[0] = '\0';
+        slot.status.store(status, std::memory_order_relaxed);
+        slot.seq.store(seq, std::memory_order_release);
+        return wasFinal;
+    }
+
+    /**
+     * Slot owned by `seq`, nullptr when it was reused or never claimed.
+     */
+    [[nodiscard]] OrderSlot* find(uint64_t seq) noexcept {
+        OrderSlot& slot = slots_[seq & MASK];
+        return (seq != 0 && slot.seq.load(std::memory_order_acquire) == seq) ? &slot : nullptr;
+    }
+
+private:
+    static constexpr uint64_t MASK = CAPACITY - 1;
+
+    const std::string prefix_;
+    std::atomic<uint64_t> nextSeq_{1};  // 0 is "not one of ours"
+    std::unique_ptr<OrderSlot[]> slots_ = std::make_unique<OrderSlot[]>(CAPACITY);
+};
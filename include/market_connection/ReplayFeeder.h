@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "market_connection/OrderBook.h"
+#include "market_connection/UpdateEventRing.h"
+#include "persistence/MarketDataJournal.h"
+
+/**
+ * ReplayFeeder - Drives the OrderBook from a recorded MarketDataJournal.
+ *
+ * Writes quotes exactly as the live Feeder does (OrderBook, plus the event
+ * ring when attached), one recorded FIX message per step. Runs on the
+ * caller's thread, so a replay at max speed is fully deterministic.
+ *
+ * Speed: 0 = as fast as possible, 1 = real time, N = N times real time.
+ */
+class ReplayFeeder {
+public:
+    ReplayFeeder(const std::string& journalPath, OrderBook& orderBook, double speed = 0.0);
+
+    ReplayFeeder(const ReplayFeeder&) = delete;
+    ReplayFeeder& operator=(const ReplayFeeder&) = delete;
+
+    /**
+     * Optional ordered event stream, same contract as Feeder::setEventRing.
+     */
+    void setEventRing(UpdateEventRing* ring) { eventRing_ = ring; }
+
+    /**
+     * Apply the next recorded message (all records sharing one receive
+     * timestamp), sleeping first if paced. Returns false once exhausted.
+     */
+    bool next();
+
+    /**
+     * Symbols present in the journal dictionary.
+     */
+    [[nodiscard]] std::vector<std::string> symbols() const;
+
+    [[nodiscard]] uint64_t position() const noexcept { return position_; }
+    [[nodiscard]] uint64_t recordCount() const noexcept { return journal_.recordCount(); }
+    [[nodiscard]] uint64_t currentTimeNs() const noexcept { return currentTimeNs_; }
+    [[nodiscard]] double speed() const noexcept { return speed_; }
+
+private:
+    MarketDataJournalReader journal_;
+    OrderBook& orderBook_;
+    UpdateEventRing* eventRing_ = nullptr;
+    double speed_;
+
+    // Recorder SymbolId -> SymbolId in this process's registry
+    std::array<SymbolId, MAX_SYMBOLS> idMap_;
+
+    uint64_t position_ = 0;
+    uint64_t currentTimeNs_ = 0;
+    uint64_t firstTimeNs_ = 0;
+    std::chrono::steady_clock::time_point wallStart_;
+
+    void pace(uint64_t recvTimeNs);
+    void applyRecord(const JournalRecord& record);
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/SpscRing.h"
+#include "market_connection/OrderBook.h"
+
+/**
+ * One top-of-book change as seen by the Feeder, in arrival order.
+ */
+struct UpdateEvent {
+    SymbolId symbolId = INVALID_SYMBOL_ID;
+    double bid = 0.0;
+    double ask = 0.0;
+    uint64_t seq = 0;       // Producer sequence, contiguous unless events were dropped
+    uint64_t recvTsc = 0;   // readTsc() when the FIX message was received
+};
+
+/**
+ * UpdateEventRing - Ordered Feeder -> strategy event stream.
+ *
+ * Complements the OrderBook dirty set: the book still holds the latest
+ * prices, the ring preserves ordering and intermediate quotes.
+ *
+ * The producer (FIX thread) never blocks. When the ring is full the event
+ * is dropped but its sequence number is still consumed, so the consumer
+ * detects the gap and can fall back to a full re-screen.
+ */
+class UpdateEventRing {
+public:
+    explicit UpdateEventRing(size_t capacity) : ring_(capacity) {}
+
+    /**
+     * Producer side (FIX thread).
+     */
+    void publish(SymbolId id, double bid, double ask, uint64_t recvTsc) noexcept {
+        UpdateEvent event{id, bid, ask, nextSeq_++, recvTsc};
+        if (!ring_.tryPush(event)) [[unlikely]] {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Consumer side (strategy thread).
+     */
+    bool tryPop(UpdateEvent& out) noexcept {
+        return ring_.tryPop(out);
+    }
+
+    [[nodiscard]] uint64_t droppedCount() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return ring_.capacity(); }
+
+private:
+    SpscRing<UpdateEvent> ring_;
+    uint64_t nextSeq_ = 0;  // Producer-owned
+    std::atomic<uint64_t> dropped_{0};
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "market_connection/OrderBook.h"  // For SymbolId, MAX_SYMBOLS
+
+constexpr uint64_t JOURNAL_MAGIC = 0x4C4E524A5444444DULL;  // "MDDTJRNL"
+constexpr uint32_t JOURNAL_VERSION = 1;
+constexpr size_t JOURNAL_SYMBOL_NAME_LEN = 32;
+
+/**
+ * Record type - which FIX message produced the record
+ */
+enum class JournalRecordType : uint8_t {
+    Snapshot = 0,
+    Incremental = 1
+};
+
+/**
+ * Fixed-size top-of-book record (56 bytes).
+ */
+struct JournalRecord {
+    uint64_t recvTimeNs;    // Local wall clock at receipt (ns since epoch)
+    uint64_t exchTimeNs;    // Exchange SendingTime (ns since epoch, 0 if unavailable)
+    double bid;
+    double ask;
+    double bidQty;
+    double askQty;
+    SymbolId symbolId;
+    JournalRecordType type;
+    uint8_t reserved[5];
+};
+static_assert(sizeof(JournalRecord) == 56, "JournalRecord layout is part of the file format");
+
+/**
+ * File header, followed by the symbol dictionary and then the records.
+ * The dictionary is indexed by journal id (the recording process's SymbolId
+ * unless remapped on resume, see MarketDataJournal::journalId; empty name =
+ * unused id).
+ */
+struct JournalHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t dataOffset;        // Byte offset of the first record
+    uint64_t recordCount;       // Committed records (updated with release semantics)
+    uint32_t symbolCount;       // Highest defined SymbolId + 1
+    uint32_t maxSymbols;
+    char date[16];              // YYYYMMDD
+    char symbols[MAX_SYMBOLS][JOURNAL_SYMBOL_NAME_LEN];
+};
+
+/**
+ * MarketDataJournal - Append-only, memory-mapped daily market data journal.
+ *
+ * Features:
+ * - One file per day (md_YYYYMMDD.bin), resumed if it already exists
+ * - Fixed-size binary records, no formatting on the write path
+ * - File grows in chunks (ftruncate + mremap), trimmed on close()
+ *
+ * Thread safety: single writer (the FIX thread). Concurrent readers can
+ * rely on header.recordCount.
+ */
+class MarketDataJournal {
+public:
+    /**
+     * Open or create the journal for `date` (YYYYMMDD) in `outputDir`.
+     * Throws std::runtime_error on I/O failure or format mismatch.
+     */
+    MarketDataJournal(const std::string& outputDir, const std::string& date,
+                      size_t chunkRecords = 1 << 20);
+    ~MarketDataJournal();
+
+    MarketDataJournal(const MarketDataJournal&) = delete;
+    MarketDataJournal& operator=(const MarketDataJournal&) = delete;
+
+    /**
+     * Id under which this process's SymbolId is recorded; the dictionary
+     * entry is written on first use. SymbolIds are process-local (snapshot
+     * arrival order), so a resumed journal keeps the id the name already
+     * has in the file and gives new names a free id.
+     */
+    [[nodiscard]] SymbolId journalId(SymbolId id, const std::string& symbol) {
+        const SymbolId mapped = journalIds_[id];
+        if (mapped != INVALID_SYMBOL_ID) [[likely]] {
+            return mapped;
+        }
+        return defineSymbol(id, symbol);
+    }
+
+    /**
+     * Append one record (hot path).
+     */
+    void append(const JournalRecord& record);
+
+    /**
+     * Trim the file to its used size, unmap and close. Idempotent.
+     */
+    void close();
+
+    [[nodiscard]] uint64_t recordCount() const noexcept { return recordCount_; }
+    [[nodiscard]] const std::string& path() const noexcept { return path_; }
+
+    /**
+     * Build the journal file name for a date (YYYYMMDD).
+     */
+    [[nodiscard]] static std::string filename(const std::string& date);
+
+private:
+    std::string path_;
+    int fd_ = -1;
+    char* base_ = nullptr;
+    size_t mappedBytes_ = 0;
+    size_t chunkBytes_;
+    uint64_t recordCount_ = 0;
+    uint64_t capacityRecords_ = 0;
+    std::array<SymbolId, MAX_SYMBOLS> journalIds_;  // Process SymbolId -> journal id
+
+    JournalHeader* header() noexcept { return reinterpret_cast<JournalHeader*>(base_); }
+    static uint64_t dataOffset() noexcept;
+    void openMapping(const std::string& date, size_t fileBytes);
+    SymbolId defineSymbol(SymbolId id, const std::string& symbol);
+    void grow();
+};
+
+/**
+ * MarketDataJournalReader - Read-only memory-mapped view of a journal.
+ *
+ * Records are exposed in file order; symbol ids are the recorder's ids and
+ * must be resolved through symbol() before use in another process.
+ */
+class MarketDataJournalReader {
+public:
+    /**
+     * Map `path` read-only. Throws std::runtime_error on I/O failure or
+     * format mismatch.
+     */
+    explicit MarketDataJournalReader(const std::string& path);
+    ~MarketDataJournalReader();
+
+    MarketDataJournalReader(const MarketDataJournalReader&) = delete;
+    MarketDataJournalReader& operator=(const MarketDataJournalReader&) = delete;
+
+    [[nodiscard]] uint64_t recordCount() const noexcept { return recordCount_; }
+    [[nodiscard]] const JournalRecord& record(uint64_t index) const noexcept { return records_[index]; }
+    [[nodiscard]] const JournalRecord* begin() const noexcept { return records_; }
+    [[nodiscard]] const JournalRecord* end() const noexcept { return records_ + recordCount_; }
+
+    /**
+     * Symbol name for a recorded id (empty if undefined).
+     */
+    [[nodiscard]] std::string symbol(SymbolId id) const;
+    [[nodiscard]] uint32_t symbolCount() const noexcept { return header_->symbolCount; }
+    [[nodiscard]] std::string date() const { return header_->date; }
+
+private:
+    std::string path_;
+    const char* base_ = nullptr;
+    size_t mappedBytes_ = 0;
+    const JournalHeader* header_ = nullptr;
+    const JournalRecord* records_ = nullptr;
+    uint64_t recordCount_ = 0;
+};
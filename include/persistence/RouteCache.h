@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "market_connection/OrderBook.h"  // For SymbolId
+#include "fin/Symbol.h"
+#include "strategies/circular_arbitrage/ArbitragePath.h"  // For RouteDescriptor
+
+constexpr uint64_t ROUTE_CACHE_MAGIC = 0x4548434143455452ULL;  // "RTECACHE"
+constexpr uint32_t ROUTE_CACHE_VERSION = 2;  // 2: fixed-point filter units
+constexpr size_t ROUTE_CACHE_SYMBOL_LEN = 32;
+constexpr size_t ROUTE_CACHE_ASSET_LEN = 16;
+
+static_assert(std::is_trivially_copyable_v<SymbolFilters>, "SymbolFilters is stored as raw bytes");
+static_assert(std::is_trivially_copyable_v<RouteDescriptor>, "RouteDescriptor is stored as raw bytes");
+
+/**
+ * File header, followed by the symbol table, the strategy table and the
+ * route table, each a packed array of the structs below.
+ */
+struct RouteCacheHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t filtersSize;       // sizeof(SymbolFilters) when written
+    uint64_t key;               // RouteCache::computeKey()
+    uint32_t symbolCount;
+    uint32_t strategyCount;
+    uint64_t routeCount;
+    uint64_t fileSize;
+};
+
+/**
+ * One exchange symbol in exchange-info order (route indices refer to it).
+ */
+struct RouteCacheSymbol {
+    char symbol[ROUTE_CACHE_SYMBOL_LEN];
+    char base[ROUTE_CACHE_ASSET_LEN];
+    char quote[ROUTE_CACHE_ASSET_LEN];
+    SymbolId registryId;        // INVALID_SYMBOL_ID if never registered
+    uint8_t reserved[6];
+    SymbolFilters filters;
+};
+
+/**
+ * Routes of one starting asset: routes[firstRoute, firstRoute + routeCount).
+ */
+struct RouteCacheStrategy {
+    char startingAsset[ROUTE_CACHE_ASSET_LEN];
+    uint64_t firstRoute;
+    uint64_t routeCount;
+};
+
+/**
+ * RouteCache - Binary snapshot of exchange symbols, filters, the
+ * SymbolRegistry mapping and the discovered routes for warm restarts.
+ *
+ * The snapshot is keyed by an FNV-1a hash of the exchange-info symbol
+ * list and the ordered starting assets. On a key match the file is
+ * memory-mapped and copied out directly: no filter parsing and no route
+ * discovery. Any mismatch or I/O error is a miss, never fatal.
+ *
+ * Writes go to a temporary file renamed over the old one.
+ */
+class RouteCache {
+public:
+    explicit RouteCache(std::string path);
+
+    /**
+     * Key for an exchange-info response and the ordered starting assets
+     * (order decides which asset keeps a shared cycle).
+     */
+    [[nodiscard]] static uint64_t computeKey(
+        const nlohmann::json& exchangeInfo,
+        const std::vector<std::string>& startingAssets);
+
+    /**
+     * Load the snapshot if it matches `key`. Registers the cached symbols
+     * in the SymbolRegistry in their cached id order. Returns false on miss.
+     */
+    bool load(uint64_t key,
+              const std::vector<std::string>& startingAssets,
+              std::vector<fin::Symbol>& symbols,
+              std::vector<std::vector<RouteDescriptor>>& routes) const;
+
+    /**
+     * Write a snapshot; `routes[i]` belongs to `startingAssets[i]`.
+     * Failures are logged and leave the previous snapshot in place.
+     */
+    void save(uint64_t key,
+              const std::vector<std::string>& startingAssets,
+              const std::vector<fin::Symbol>& symbols,
+              const std::vector<std::vector<RouteDescriptor>>& routes) const;
+
+    [[nodiscard]] const std::string& path() const noexcept { return path_; }
+
+private:
+    std::string path_;
+};
@@ -1,24 +1,41 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <set>
 #include <memory>
 #include <optional>
 #include <functional>
-#include <bitset>
+#include <span>
 
 #include "strategies/circular_arbitrage/ArbitragePath.h"
+#include "strategies/circular_arbitrage/BreakEvenIndex.h"
+#include "strategies/circular_arbitrage/CycleEngine.h"
 #include "market_connection/OrderBook.h"
 #include "fin/Symbol.h"
 #include "fin/Signal.h"
 #include "fin/OrderSizer.h"
 
+/**
+ * How a tick selects the paths to evaluate.
+ */
+enum class DetectionMode {
+    Rescreen,   // Fast-ratio check of every path containing an updated symbol
+    BreakEven,  // Range query on per-symbol break-even prices
+    LogScore    // Incremental log-space scores in a max-heap
+};
+
 struct TriangularArbitrageConfig {
     std::string startingAsset;
     double defaultFee = 0.1;
     double risk = 1.0;
     double minProfitRatio = 1.0001;  // Minimum ratio (1.0001 = 0.01% profit)
+    DetectionMode detectionMode = DetectionMode::Rescreen;
+    int maxLegs = 3;                 // 4-5 adds the asset-graph cycle search
+    bool logPaths = false;           // Dump every discovered path at startup
+    std::vector<double> stakeLadder; // Stake fractions sized per candidate, empty = full stake only
     std::map<std::string, double> symbolFees;
 };
 
@@ -30,7 +47,11 @@ struct TriangularArbitrageConfig {
  * 2. Integer symbol IDs for O(1) lookups
  * 3. Inverted index for O(U) affected path lookup
  * 4. Pre-cached fee multipliers
- * 5. Bitset-based update tracking
+ * 5. Lock-free dirty-set update tracking
+ * 6. SIMD full re-screen when a burst touches a large share of paths
+ * 7. Optional break-even index: ticks trigger paths by range query
+ * 8. Optional log-score heap: best path in O(1), no per-path book reads
+ * 9. Optional 4-5 leg cycles by incremental search on the asset graph
  */
 class TriangularArbitrage {
 public:
@@ -39,29 +60,68 @@ public:
     explicit TriangularArbitrage(const TriangularArbitrageConfig& config);
     virtual ~TriangularArbitrage() = default;
 
-    void discoverRoutes(const std::vector<fin::Symbol>& symbols);
+    /**
+     * Build the path pool from the exchange symbols.
+     * With `claimedCycles`, cycles already claimed by another instance
+     * (the same legs seen from a different starting asset) are skipped,
+     * and this instance's cycles are added to the set.
+     */
+    void discoverRoutes(const std::vector<fin::Symbol>& symbols,
+                        std::set<std::string>* claimedCycles = nullptr);
+
+    /**
+     * Build the path pool from routes kept by an earlier discoverRoutes()
+     * on the same symbol list (route cache), skipping discovery.
+     */
+    void loadRoutes(const std::vector<fin::Symbol>& symbols, std::vector<RouteDescriptor> routes);
+
+    /**
+     * Routes behind the current path pool, indices into the symbol list.
+     */
+    const std::vector<RouteDescriptor>& routes() const { return routes_; }
     const std::set<std::string>& subscribedSymbols() const { return stratSymbols_; }
 
     /**
-     * Process market data updates (bitset version - preferred).
+     * Process market data updates (mask of symbols drained from the OrderBook).
      */
     std::optional<Signal> onMarketDataUpdate(
-        const std::bitset<MAX_SYMBOLS>& updatedSymbols,
+        const UpdateMask& updatedSymbols,
         const OrderBook& orderBook,
         double stake,
         const OrderSizer& sizer);
 
+    /**
+     * Process a single symbol update (event-queue mode).
+     * Evaluates only the paths that contain the symbol that moved.
+     */
+    std::optional<Signal> onSymbolUpdate(
+        SymbolId symbolId,
+        const OrderBook& orderBook,
+        double stake,
+        const OrderSizer& sizer);
+
+    /**
+     * Price candidates against the L2 book (VWAP per leg) instead of level 1.
+     * nullptr restores top-of-book evaluation.
+     */
+    void setDepthBook(const DepthBook* depthBook) { depthBook_ = depthBook; }
+
     const std::string& startingAsset() const { return startingAsset_; }
     double risk() const { return risk_; }
     double getFeeForSymbol(const std::string& symbol) const;
 
     size_t pathCount() const { return pathPool_.size(); }
+    int maxLegs() const { return maxLegs_; }
 
 private:
     std::string startingAsset_;
     double defaultFee_;
     double risk_;
     double minProfitRatio_;
+    DetectionMode detectionMode_;
+    int maxLegs_;
+    bool logPaths_;
+    std::vector<double> stakeLadder_;
     std::map<std::string, double> symbolFees_;
 
     // Cached fee function
@@ -70,11 +130,59 @@ private:
     // Path pool with inverted index
     ArbitragePathPool pathPool_;
 
+    // Optional L2 book for VWAP evaluation (not owned)
+    const DepthBook* depthBook_ = nullptr;
+
     std::set<std::string> stratSymbols_;
+    std::vector<RouteDescriptor> routes_;
+
+    // Reused candidate buffer for full SIMD re-screens / break-even hits
+    std::vector<uint32_t> screenCandidates_;
+
+    // DetectionMode::BreakEven only
+    BreakEvenIndex breakEvenIndex_;
+
+    // Cycles longer than three legs (maxLegs > 3 only)
+    std::unique_ptr<CycleEngine> cycleEngine_;
+
+    std::optional<Signal> detectPaths(
+        const UpdateMask& updatedSymbols,
+        const OrderBook& orderBook,
+        double stake,
+        const OrderSizer& sizer);
+
+    std::optional<Signal> detectPathsForSymbol(
+        SymbolId symbolId,
+        const OrderBook& orderBook,
+        double stake,
+        const OrderSizer& sizer);
+
+    std::optional<Signal> withCycles(
+        std::optional<Signal> pathSignal,
+        const OrderBook& orderBook,
+        double stake,
+        const OrderSizer& sizer);
+
+    std::optional<Signal> evaluatePaths(
+        std::span<const uint32_t> pathIndices,
+        const OrderBook& orderBook,
+        double stake,
+        const OrderSizer& sizer);
+
+    /**
+     * Debug trace of the theoretical (unrounded) walk of one path. Reads
+     * the cold table and builds strings: only for paths that produced a
+     * signal, never for every candidate above the threshold.
+     */
+    void logPathTrace(uint32_t pathIdx, const PathQuotes& quotes, double feeRate) const;
+
+    /**
+     * Enumerate triangles through a CSR asset -> symbol index on integer
+     * ids; first legs are split across threads, output keeps symbol order.
+     */
+    void buildPool(const std::vector<fin::Symbol>& symbols);
 
-    std::vector<Order> getPossibleOrders(const std::string& coin, const std::vector<fin::Symbol>& relatedSymbols);
-    std::vector<ArbitragePath> computeArbitragePaths(
+    std::vector<RouteDescriptor> computeArbitragePaths(
         const std::vector<fin::Symbol>& symbolsList,
-        const std::string& startingAsset,
-        int arbitrageDepth);
+        const std::string& startingAsset) const;
 };
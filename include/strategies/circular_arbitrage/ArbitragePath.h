@@ -2,12 +2,17 @@
 
 #include <vector>
 #include <array>
+#include <cmath>
+#include <limits>
 #include <string>
-#include <memory>
 #include <optional>
 #include <functional>
+#include <span>
 
 #include "market_connection/OrderBook.h"
+#include "market_connection/DepthBook.h"
+#include "strategies/circular_arbitrage/PathMatrix.h"
+#include "strategies/circular_arbitrage/PathScores.h"
 #include "fin/Order.h"
 #include "fin/Signal.h"
 #include "fin/OrderSizer.h"
@@ -15,114 +20,231 @@
 using FeeFunction = std::function<double(const std::string&)>;
 
 /**
- * ArbitragePath - High-performance triangular arbitrage path.
+ * Compact triangle: indices into the exchange symbol list plus directions.
+ * Trivially copyable, stored as-is in the route cache.
+ */
+struct RouteDescriptor {
+    std::array<uint32_t, 3> symbols;
+    std::array<bool, 3> isBuy;
+};
+
+class ArbitragePathPool;
+struct PathQuotes;
+
+/**
+ * Sizing kernel of one path, specialised on its direction mask.
+ */
+using EvaluateKernel = std::optional<Signal> (*)(
+    const ArbitragePathPool& pool, uint32_t index, const PathQuotes& quotes, double initialStake);
+
+/**
+ * PathRecord - Hot data of one triangle, exactly one cache line.
+ *
+ * Everything the screens and the ratio check touch. Strings and Orders
+ * live in PathColdData and are only read once a path is worth sizing, so
+ * the hot set of a starting asset is one contiguous array of these.
+ */
+struct alignas(64) PathRecord {
+    std::array<SymbolId, 3> ids{};
+    uint8_t buyMask = 0;                     // Bit `leg` set when the leg is a BUY
+    double feeProduct = 0.0;                 // Product of the three fee multipliers
+    std::array<double, 3> feeMultipliers{};  // (1 - fee/100) per leg
+    double ratio = 0.0;                      // Fast ratio at the last refresh, 0 = missing price
+    EvaluateKernel kernel = nullptr;         // evaluate() for this buyMask
+
+    [[nodiscard]] bool isBuy(size_t leg) const noexcept {
+        return (buyMask >> leg) & 1;
+    }
+
+    [[nodiscard]] bool containsSymbol(SymbolId id) const noexcept {
+        return ids[0] == id || ids[1] == id || ids[2] == id;
+    }
+};
+static_assert(sizeof(PathRecord) == 64, "PathRecord must stay one cache line");
+
+/**
+ * Top of book of the three legs, read once per evaluation (on the stack).
+ */
+struct PathQuotes {
+    std::array<double, 3> bids{};
+    std::array<double, 3> asks{};
+    std::array<double, 3> bidQtys{};  // 0 = unknown
+    std::array<double, 3> askQtys{};
+    std::array<double, 3> rates{};    // 1/ask for BUY, bid for SELL; 0 = missing price
+};
+
+/**
+ * Lot rounding of one leg, precomputed from the symbol's MARKET_LOT_SIZE
+ * (LOT_SIZE when absent) in fixed-point units. Same result as
+ * SymbolFilters::roundMarketQty, with selects instead of branches: a
+ * missing step is 1 unit, a missing max is INT64_MAX.
+ */
+struct LegLot {
+    int64_t stepUnits = 1;
+    int64_t minUnits = 0;
+    int64_t maxUnits = std::numeric_limits<int64_t>::max();
+
+    static LegLot fromFilters(const SymbolFilters& filters);
+
+    [[nodiscard]] double round(double qty) const noexcept {
+        const int64_t units = Filters::toUnits(qty);
+        const int64_t stepped = units - units % stepUnits;
+        return Filters::fromUnits(std::min(maxUnits, std::max(minUnits, stepped)));
+    }
+};
+
+/**
+ * Cold data of one triangle: only for signals and logging.
+ */
+struct PathColdData {
+    std::vector<Order> orders;
+    std::string description;
+};
+
+/**
+ * ArbitragePathPool - Triangles as a hot PathRecord array plus a cold side
+ * table, with an inverted index for O(1) lookup, a SIMD path matrix for
+ * full re-screens and optional log-space scores.
+ *
+ * The inverted index is CSR: the paths of symbol s are
+ * pathIndex_[pathOffsets_[s] .. pathOffsets_[s + 1]), one flat array.
  *
  * Optimizations:
  * 1. Uses SymbolId (integer) for O(1) lookups
  * 2. Pre-computed fee multipliers
- * 3. Cache-aligned data layout
- * 4. Cached description string
+ * 3. One 64-byte record per path, no per-path heap objects on the hot path
+ * 4. Description built once, in the cold table
  * 5. Batch price reads with prefetch
+ * 6. Stake capped by top-of-book liquidity
  */
-class ArbitragePath {
+class ArbitragePathPool {
 public:
-    ArbitragePath(std::vector<Order> orders, const FeeFunction& getFee);
+    static constexpr size_t MAX_STAKE_RUNGS = 8;
+
+    size_t addPath(std::vector<Order> orders, const FeeFunction& getFee);
+    void buildIndex();
 
     /**
-     * Update cached prices from order book (~15ns).
+     * Paths touching any updated symbol, each once. The span points into a
+     * buffer owned by the pool and is valid until the next call; no
+     * allocation per tick. Single-threaded (detection thread).
      */
-    void updatePrices(const OrderBook& orderBook);
+    [[nodiscard]] std::span<const uint32_t> getAffectedPaths(const UpdateMask& updatedSymbols);
+
+    [[nodiscard]] std::span<const uint32_t> pathsForSymbol(SymbolId id) const noexcept {
+        const uint32_t first = pathOffsets_[id];
+        return {pathIndex_.data() + first, pathOffsets_[id + 1] - first};
+    }
 
     /**
-     * Fast profitability check (~5ns).
-     * Returns ratio > 1.0 if potentially profitable.
+     * Fast screen of every path against the live book (see PathMatrix).
+     * Fills `out` with candidate indices; re-check before trading.
      */
-    [[nodiscard]] double getFastRatio() const noexcept;
+    void screenAll(const OrderBook& orderBook, double minRatio, std::vector<uint32_t>& out) const {
+        matrix_.screen(orderBook, minRatio, out);
+    }
 
     /**
-     * Full evaluation with order sizing (~500ns).
+     * Log-score heap; populated by buildScores() (DetectionMode::LogScore).
      */
-    [[nodiscard]] std::optional<Signal> evaluate(
-        double initialStake,
-        const OrderBook& orderBook,
-        const OrderSizer& orderSizer,
-        const FeeFunction& getFee) const;
+    void buildScores() { scores_.build(*this); }
+    [[nodiscard]] PathScores& scores() noexcept { return scores_; }
 
-    [[nodiscard]] const std::string& description() const noexcept {
-        return cachedDescription_;
-    }
+    /**
+     * Read the three legs from the book into `quotes`, cache and return the
+     * fast ratio: product of (rate * fee multiplier), 0 on a missing price.
+     */
+    double refresh(uint32_t index, const OrderBook& orderBook, PathQuotes& quotes) noexcept;
 
-    [[nodiscard]] const std::array<std::string, 3>& symbols() const { return symbolStrings_; }
-    [[nodiscard]] const std::array<SymbolId, 3>& symbolIds() const { return symbolIds_; }
-    [[nodiscard]] const std::vector<Order>& orders() const { return orders_; }
+    /**
+     * Largest stake (in starting-asset units) executable against the quoted
+     * top-of-book sizes. +inf when no leg reports a size.
+     */
+    [[nodiscard]] double maxExecutableStake(uint32_t index, const PathQuotes& quotes) const noexcept;
 
-    // Accessors for cached market data (for debug logging)
-    [[nodiscard]] const std::array<double, 3>& cachedBids() const noexcept { return bids_; }
-    [[nodiscard]] const std::array<double, 3>& cachedAsks() const noexcept { return asks_; }
-    [[nodiscard]] const std::array<bool, 3>& legDirections() const noexcept { return isBuy_; }
-    [[nodiscard]] const std::array<double, 3>& feeMultipliers() const noexcept { return feeMultipliers_; }
+    /**
+     * Stake ladder: fractions of the stake passed to evaluate(), at most
+     * MAX_STAKE_RUNGS. Empty means the single full stake.
+     */
+    void setStakeLadder(const std::vector<double>& fractions);
 
     /**
-     * Check if path contains a specific symbol.
+     * Full evaluation with order sizing on quotes from refresh(), through
+     * the path's kernel. Every ladder rung is sized in the same pass (capped
+     * at maxExecutableStake()); the signal carries the best-pnl rung.
      */
-    [[nodiscard]] bool containsSymbol(SymbolId id) const noexcept {
-        return symbolIds_[0] == id || symbolIds_[1] == id || symbolIds_[2] == id;
+    [[nodiscard]] std::optional<Signal> evaluate(
+        uint32_t index,
+        const PathQuotes& quotes,
+        double initialStake) const
+    {
+        return records_[index].kernel(*this, index, quotes, initialStake);
     }
 
-private:
-    std::vector<Order> orders_;
-
-    // Symbol identifiers
-    std::array<SymbolId, 3> symbolIds_;
-    std::array<std::string, 3> symbolStrings_;
-
-    // Leg configuration
-    std::array<bool, 3> isBuy_;
-
-    // Pre-computed fee multipliers: (1 - fee/100)
-    std::array<double, 3> feeMultipliers_;
-
-    // Cached prices
-    alignas(32) std::array<double, 3> bids_{0.0, 0.0, 0.0};
-    alignas(32) std::array<double, 3> asks_{0.0, 0.0, 0.0};
+    /**
+     * Depth-aware evaluation: walks the L2 levels of each leg and prices it
+     * at its VWAP, once per ladder rung. The stake is capped at what the
+     * visible depth can absorb.
+     */
+    [[nodiscard]] std::optional<Signal> evaluateVwap(
+        uint32_t index,
+        double initialStake,
+        const DepthBook& depthBook,
+        const OrderSizer& orderSizer) const;
 
-    // Effective multipliers for ratio computation
-    alignas(32) std::array<double, 3> effectiveMultipliers_{0.0, 0.0, 0.0};
+    [[nodiscard]] const PathRecord& record(size_t index) const noexcept { return records_[index]; }
+    [[nodiscard]] std::span<const PathRecord> records() const noexcept { return records_; }
+    [[nodiscard]] const PathColdData& cold(size_t index) const noexcept { return cold_[index]; }
 
-    // Cached description
-    std::string cachedDescription_;
+    [[nodiscard]] size_t size() const noexcept { return records_.size(); }
 
-    // Validity flag
-    bool pricesValid_ = false;
+private:
+    std::vector<PathRecord> records_;
+    std::vector<std::array<LegLot, 3>> lots_;  // Read by the kernels only
+    std::vector<PathColdData> cold_;
 
-    // Working buffers for allocation-free evaluate()
-    mutable std::array<double, 3> workingPrices_;
-    mutable std::array<double, 3> workingQtys_;
+    // CSR inverted index, SymbolId -> path indices
+    std::vector<uint32_t> pathOffsets_ = std::vector<uint32_t>(MAX_SYMBOLS + 1, 0);
+    std::vector<uint32_t> pathIndex_;
 
-    void buildDescription();
-};
-
-/**
- * ArbitragePathPool - Collection with inverted index for O(1) lookup.
- */
-class ArbitragePathPool {
-public:
-    size_t addPath(std::shared_ptr<ArbitragePath> path);
-    void buildIndex();
+    // getAffectedPaths(): generation-stamped dedupe and result buffer
+    std::vector<uint32_t> seenGen_;
+    uint32_t generation_ = 0;
+    std::vector<uint32_t> affected_;
 
-    [[nodiscard]] std::vector<size_t> getAffectedPaths(
-        const std::bitset<MAX_SYMBOLS>& updatedSymbols) const;
+    PathMatrix matrix_;
+    PathScores scores_;
 
-    [[nodiscard]] std::shared_ptr<ArbitragePath>& getPath(size_t index) {
-        return paths_[index];
-    }
+    // Stake fractions, padded with 0 up to MAX_STAKE_RUNGS
+    std::array<double, MAX_STAKE_RUNGS> ladder_{1.0};
+    size_t ladderSize_ = 1;
 
-    [[nodiscard]] size_t size() const noexcept { return paths_.size(); }
+    /**
+     * One instantiation per direction mask (bit `leg` = BUY): the leg
+     * sequence is fixed at compile time and the invalid-price / zero-lot
+     * checks are folded into a single test at the end.
+     */
+    template <uint8_t BuyMask>
+    static std::optional<Signal> evaluateKernel(
+        const ArbitragePathPool& pool, uint32_t index, const PathQuotes& quotes, double initialStake);
 
-    auto begin() { return paths_.begin(); }
-    auto end() { return paths_.end(); }
+    static EvaluateKernel kernelFor(uint8_t buyMask) noexcept;
 
-private:
-    std::vector<std::shared_ptr<ArbitragePath>> paths_;
-    std::array<std::vector<size_t>, MAX_SYMBOLS> symbolToPathIndex_;
+    /**
+     * VWAP walk of one stake through the snapshots; pnl, or 0 when a leg
+     * cannot fill or rounds to nothing.
+     */
+    double walkDepth(
+        uint32_t index,
+        double stake,
+        const std::array<DepthSnapshot, 3>& books,
+        const OrderSizer& orderSizer,
+        std::array<double, 3>& prices,
+        std::array<double, 3>& qtys) const;
+
+    std::optional<Signal> makeSignal(
+        uint32_t index,
+        const std::array<double, 3>& prices,
+        const std::array<double, 3>& qtys,
+        double pnl) const;
 };
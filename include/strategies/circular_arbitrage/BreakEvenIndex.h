@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "market_connection/OrderBook.h"
+
+class ArbitragePathPool;
+
+/**
+ * BreakEvenIndex - Per-symbol sorted break-even prices for tick-driven triggering.
+ *
+ * With the other two legs fixed, a path becomes profitable exactly when
+ * the price of its remaining leg crosses a break-even:
+ * - SELL leg: bid > minRatio / (F * m_other1 * m_other2)
+ * - BUY leg:  ask < (F * m_other1 * m_other2) / minRatio
+ * where F is the fee product and m = bid (SELL) or 1/ask (BUY).
+ *
+ * Each (SymbolId, side) keeps its break-evens in an ordered set, so a
+ * tick is a range query from the end of the set. When a symbol moves,
+ * only the thresholds of the other legs of its paths change; they are
+ * repositioned with node extract/insert (no allocation).
+ *
+ * Candidates are re-checked by the caller (seqlocked read in ArbitragePathPool::refresh).
+ * Single-threaded: owned by the detection thread.
+ */
+class BreakEvenIndex {
+public:
+    void build(const ArbitragePathPool& pool, double minRatio);
+
+    /**
+     * Refresh one symbol from the book and append newly profitable paths.
+     */
+    void onSymbolUpdate(SymbolId id, const OrderBook& orderBook, std::vector<uint32_t>& out);
+
+    /**
+     * Refresh every symbol in the mask, then query each of them.
+     * Candidates are deduplicated.
+     */
+    void onUpdates(const UpdateMask& updated, const OrderBook& orderBook, std::vector<uint32_t>& out);
+
+    [[nodiscard]] bool empty() const noexcept { return paths_.empty(); }
+
+private:
+    using Entry = std::pair<double, uint32_t>;  // (break-even price, path index)
+
+    struct PathLegs {
+        std::array<SymbolId, 3> ids;
+        std::array<bool, 3> isBuy;
+        std::array<double, 3> thresholds;
+        double feeProduct;
+    };
+
+    const ArbitragePathPool* pool_ = nullptr;
+    double minRatio_ = 1.0;
+    std::vector<PathLegs> paths_;
+
+    // Sorted break-evens per (SymbolId, side): index id * 2 + isBuy
+    std::vector<std::set<Entry>> sides_;
+
+    // Last multiplier seen per symbol (0 = no valid price yet)
+    std::vector<double> sellMult_;  // bid
+    std::vector<double> buyMult_;   // 1 / ask
+    std::vector<double> lastBid_;
+    std::vector<double> lastAsk_;
+
+    // Generation-stamped dedupe for onUpdates()
+    std::vector<uint32_t> seenGen_;
+    uint32_t generation_ = 0;
+
+    static size_t sideIndex(SymbolId id, bool isBuy) noexcept {
+        return static_cast<size_t>(id) * 2 + (isBuy ? 1 : 0);
+    }
+
+    double computeThreshold(const PathLegs& path, size_t leg) const noexcept;
+    void refresh(SymbolId id, const OrderBook& orderBook);
+    void query(SymbolId id, std::vector<uint32_t>& out, bool dedupe);
+};
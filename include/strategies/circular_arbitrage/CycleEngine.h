@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "market_connection/OrderBook.h"
+#include "fin/Symbol.h"
+#include "fin/Signal.h"
+#include "fin/OrderSizer.h"
+#include "strategies/circular_arbitrage/ArbitragePath.h"
+
+/**
+ * CycleEngine - 4 and 5 leg cycles found by an incremental search on the
+ * asset graph instead of enumerating every path up front.
+ *
+ * Nodes are assets; each symbol gives two edges weighted by -log(rate):
+ * - SELL base -> quote: -log(bid * fee)
+ * - BUY quote -> base:  log(ask) - log(fee)
+ * A cycle is profitable when its total weight is below -log(minRatio).
+ *
+ * The search is a hop-bounded Bellman-Ford from the starting asset:
+ * dist[k][v] is the lightest k-edge walk start -> v. A tick only changes
+ * the weights of the updated symbols' edges, so layer k re-relaxes the
+ * heads of those edges plus the successors of nodes whose dist[k-1]
+ * moved; cost scales with the touched edges, not with the cycle count.
+ * Closing walks are read from the in-edges of the starting asset.
+ *
+ * The lightest walk of a given length may revisit an asset; such walks
+ * are rejected when the cycle is rebuilt, so a simple cycle hidden
+ * behind a better non-simple walk of the same length is not reported.
+ *
+ * Edges that cannot lie on a cycle of at most maxLegs through the
+ * starting asset are pruned when the graph is built.
+ *
+ * Single-threaded: owned by the detection thread.
+ */
+class CycleEngine {
+public:
+    static constexpr int MAX_CYCLE_LEGS = 5;
+
+    CycleEngine(int minLegs, int maxLegs);
+
+    void build(const std::vector<fin::Symbol>& symbols,
+               const std::string& startingAsset,
+               const FeeFunction& getFee);
+
+    /**
+     * Reload the edges of one symbol and re-relax the affected layers.
+     */
+    void onSymbolUpdate(SymbolId id, const OrderBook& orderBook);
+
+    /**
+     * Reload the edges of every symbol in the mask, then re-relax once.
+     */
+    void onUpdates(const UpdateMask& updated, const OrderBook& orderBook);
+
+    /**
+     * Lightest closing cycle above minRatio, sized with the live book.
+     */
+    [[nodiscard]] std::optional<Signal> findSignal(
+        double minRatio,
+        double initialStake,
+        const OrderBook& orderBook,
+        const OrderSizer& orderSizer);
+
+    [[nodiscard]] const std::set<std::string>& symbols() const noexcept { return symbolNames_; }
+    [[nodiscard]] size_t edgeCount() const noexcept { return edges_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return edges_.empty(); }
+
+private:
+    struct Edge {
+        uint32_t from;
+        uint32_t to;
+        uint32_t symbolIdx;  // Index into symbols_
+        SymbolId symbolId;
+        bool isBuy;
+        double logFee;       // -log(feeMultiplier)
+        double feeMultiplier;
+    };
+
+    int minLegs_;
+    int maxLegs_;
+    uint32_t start_ = 0;
+
+    std::vector<fin::Symbol> symbols_;
+    std::set<std::string> symbolNames_;
+
+    std::vector<Edge> edges_;
+    std::vector<double> weights_;                 // +inf = no valid price
+    std::vector<uint32_t> inStart_, inEdges_;     // CSR by head
+    std::vector<uint32_t> outStart_, outEdges_;   // CSR by tail
+
+    // Per SymbolId: first edge (SELL), BUY is the next one; -1 when absent
+    std::vector<int32_t> symbolEdge_;
+
+    // Layers 0 .. maxLegs-1
+    std::array<std::vector<double>, MAX_CYCLE_LEGS> dist_;
+    std::array<std::vector<int32_t>, MAX_CYCLE_LEGS> pred_;
+
+    // Incremental relaxation state
+    std::vector<uint32_t> touched_;
+    std::vector<uint32_t> changed_;
+    std::vector<uint32_t> nextChanged_;
+    std::vector<uint32_t> dirty_;
+    std::vector<uint32_t> nodeStamp_;
+    uint32_t stamp_ = 0;
+
+    std::vector<uint32_t> cycle_;
+
+    void refresh(SymbolId id, const OrderBook& orderBook);
+    void relax();
+    void markDirty(uint32_t node);
+    bool rebuildCycle(uint32_t closingEdge, int legs);
+    std::optional<Signal> evaluateCycle(
+        double initialStake,
+        const OrderBook& orderBook,
+        const OrderSizer& orderSizer) const;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "market_connection/OrderBook.h"
+
+struct PathRecord;
+
+/**
+ * PathMatrix - Structure-of-arrays copy of every path for the SIMD fast screen.
+ *
+ * Layout (one column per path, padded to PATH_MATRIX_LANES):
+ * - legOffsets_[leg]: leg SymbolId pre-scaled to its price in the OrderBook
+ *   slot array (ask for BUY legs, bid for SELL legs)
+ * - dirMasks_: bit `leg` set when the leg is a BUY
+ * - feeProducts_: product of the three fee multipliers
+ *
+ * screen() gathers prices straight from the slots and tests
+ *   feeProduct * prod(SELL bids) > minRatio * prod(BUY asks)
+ * which is the pool's fast ratio > minRatio without divisions. AVX-512 does 8 paths
+ * per step, AVX2 4, with a scalar fallback; chosen at compile time.
+ *
+ * The gather bypasses the seqlock, so candidates must be re-checked through
+ * ArbitragePathPool::refresh(). A small tolerance keeps
+ * borderline paths in the candidate set rather than dropping them.
+ */
+class PathMatrix {
+public:
+    static constexpr size_t PATH_MATRIX_LANES = 8;
+
+    void build(const std::vector<PathRecord>& paths);
+
+    /**
+     * Append the index of every path with ratio > minRatio to `out`.
+     */
+    void screen(const OrderBook& orderBook, double minRatio, std::vector<uint32_t>& out) const;
+
+    [[nodiscard]] size_t size() const noexcept { return pathCount_; }
+
+private:
+    size_t pathCount_ = 0;
+    std::array<std::vector<int32_t>, 3> legOffsets_;
+    std::vector<uint8_t> dirMasks_;
+    std::vector<double> feeProducts_;
+
+    void screenScalar(const double* prices, double threshold, std::vector<uint32_t>& out) const;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "market_connection/OrderBook.h"
+
+class ArbitragePathPool;
+
+/**
+ * PathScores - Log-space path scores kept in an indexed max-heap.
+ *
+ * Leg rate in log space: log(bid) for SELL, -log(ask) for BUY, plus
+ * log(feeMultiplier). A path score is the sum of its three legs, so
+ * score > log(minRatio) <=> fast ratio > minRatio (ArbitragePathPool::refresh).
+ *
+ * A tick reads the symbol once, updates its cached log prices, then
+ * rescores only the paths containing it (three adds from the cache, no
+ * book reads) and sifts them in the heap. The best path is heap[0].
+ * Rescoring from the cache instead of applying deltas avoids drift from
+ * millions of add/subtract pairs and handles missing prices (-inf).
+ *
+ * Single-threaded: owned by the detection thread.
+ */
+class PathScores {
+public:
+    void build(const ArbitragePathPool& pool);
+
+    /**
+     * Refresh one symbol from the book and rescore its paths.
+     */
+    void onSymbolUpdate(SymbolId id, const OrderBook& orderBook);
+
+    /**
+     * Refresh every symbol in the mask and rescore their paths.
+     */
+    void onUpdates(const UpdateMask& updated, const OrderBook& orderBook);
+
+    /**
+     * Append paths rescored since the last collect() whose ratio exceeds
+     * minRatio, walking only the part of the heap above the threshold.
+     */
+    void collect(double minRatio, std::vector<uint32_t>& out);
+
+    [[nodiscard]] bool empty() const noexcept { return heap_.empty(); }
+    [[nodiscard]] size_t bestPath() const noexcept { return heap_.front(); }
+    [[nodiscard]] double bestScore() const noexcept { return scores_[heap_.front()]; }
+
+private:
+    const ArbitragePathPool* pool_ = nullptr;
+
+    // Per path
+    std::vector<std::array<SymbolId, 3>> legIds_;
+    std::vector<uint8_t> dirMasks_;       // Bit `leg` set when BUY
+    std::vector<double> logFees_;         // Sum of log(feeMultiplier)
+    std::vector<double> scores_;
+    std::vector<uint32_t> touchedGen_;
+    uint32_t generation_ = 1;
+
+    // Per symbol cached leg rates (-inf = no valid price)
+    std::vector<double> logSell_;         // log(bid)
+    std::vector<double> logBuy_;          // -log(ask)
+
+    // Indexed max-heap over path indices
+    std::vector<uint32_t> heap_;
+    std::vector<uint32_t> heapPos_;
+    std::vector<uint32_t> dfsStack_;
+
+    void refresh(SymbolId id, const OrderBook& orderBook);
+    double computeScore(size_t pathIdx) const noexcept;
+    void siftUp(uint32_t pos) noexcept;
+    void siftDown(uint32_t pos) noexcept;
+    void swapNodes(uint32_t a, uint32_t b) noexcept;
+};
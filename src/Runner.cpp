@@ -2,6 +2,53 @@
 #include "codegen/fix/OE/FixValues.h"
 #include "logger.hpp"
 #include "crypto/utils.hpp"
+#include "common/Tsc.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+namespace {
+    const char* pollingModeName(PollingMode mode) {
+        switch (mode) {
+            case PollingMode::Blocking:   return "Blocking";
+            case PollingMode::BusyPoll:   return "BusyPoll";
+            case PollingMode::EventQueue: return "EventQueue";
+            case PollingMode::Hybrid:
+            default:                      return "Hybrid";
+        }
+    }
+
+    // Parallel mode: market BUYs can cost a little more than estimated
+    constexpr double PARALLEL_BALANCE_HEADROOM = 1.02;
+
+    // std::stod with the config key in the error, and no trailing garbage
+    double parseConfigDouble(const std::string& key, const std::string& value) {
+        size_t parsed = 0;
+        double result = 0.0;
+        try {
+            result = std::stod(value, &parsed);
+        } catch (const std::exception&) {
+            parsed = 0;
+        }
+        if (parsed == 0 || parsed != value.size()) {
+            throw std::runtime_error(key + ": '" + value + "' is not a number");
+        }
+        return result;
+    }
+
+    // Starting-asset amount the signal commits on its first leg
+    double signalStake(const Signal& signal) {
+        const Order& first = signal.orders.front();
+        return first.getWay() == Way::BUY ? first.getQty() * first.getPrice() : first.getQty();
+    }
+
+    // Comparable across starting assets: pnl per unit staked
+    double returnOnStake(const Signal& signal) {
+        const double stake = signalStake(signal);
+        return stake > 0 ? signal.pnl / stake : 0.0;
+    }
+}
 
 Runner::Runner(const RunnerConfig& config)
     : config_(config)
@@ -12,40 +59,184 @@ Runner::Runner(const RunnerConfig& config)
     LOG_INFO("[Runner] Creating Admin (REST client) for: {}", config.restEndpoint);
     admin_ = std::make_unique<Admin>(config.restEndpoint, config.apiKey, *key_);
 
-    LOG_INFO("[Runner] Creating Feeder (FIX market data)");
-    feeder_ = std::make_unique<Feeder>(config.apiKey, *key_, orderBook_);
+    if (!config.replayJournal.empty()) {
+        LOG_INFO("[Runner] Creating ReplayFeeder (journal: {})", config.replayJournal);
+        replayFeeder_ = std::make_unique<ReplayFeeder>(config.replayJournal, orderBook_, config.replaySpeed);
+
+        if (config_.liveMode) {
+            LOG_WARNING("[Runner] liveMode ignored in replay, orders are simulated");
+            config_.liveMode = false;
+        }
+    } else {
+        LOG_INFO("[Runner] Creating Feeder (FIX market data)");
+        feeder_ = std::make_unique<Feeder>(config.apiKey, *key_, orderBook_);
+    }
+
+    if (config.pollingMode == PollingMode::EventQueue) {
+        eventRing_ = std::make_unique<UpdateEventRing>(config.eventRingCapacity);
+        if (replayFeeder_) {
+            replayFeeder_->setEventRing(eventRing_.get());
+        } else {
+            feeder_->setEventRing(eventRing_.get());
+        }
+        LOG_INFO("[Runner] Event ring attached to Feeder (capacity={})", eventRing_->capacity());
+    }
+
+    if (config.marketDepth > 1) {
+        if (replayFeeder_) {
+            LOG_WARNING("[Runner] Journals carry top of book only, marketDepth ignored in replay");
+        } else {
+            depthBook_ = std::make_unique<DepthBook>(config.marketDepth);
+            feeder_->setDepthBook(depthBook_.get());
+            LOG_INFO("[Runner] Depth book enabled (depth={})", depthBook_->depth());
+        }
+    }
 
-    LOG_INFO("[Runner] Creating Broker (FIX order execution, liveMode={})", config.liveMode);
-    broker_ = std::make_unique<Broker>(config.apiKey, *key_, config.liveMode);
+    LOG_INFO("[Runner] Creating Broker (FIX order execution, liveMode={})", config_.liveMode);
+    broker_ = std::make_unique<Broker>(config.apiKey, *key_, config_.liveMode);
+    pipelines_ = std::make_unique<LegPipelinePool>(*broker_, config.maxConcurrentArbitrages);
+    broker_->setOrderListener(pipelines_.get());
+    inFlight_.resize(pipelines_->size());
+    rollbacks_.resize(pipelines_->size());
+    signalQueue_ = std::make_unique<SpscRing<PlannedArbitrage*>>(SIGNAL_QUEUE_CAPACITY);
 
-    LOG_INFO("[Runner] Creating TriangularArbitrage strategy");
-    strategy_ = std::make_unique<TriangularArbitrage>(config.strategyConfig);
+    if (config.strategyConfigs.empty()) {
+        throw std::runtime_error("Runner: no starting asset configured");
+    }
+    LOG_INFO("[Runner] Creating {} TriangularArbitrage instance(s)", config.strategyConfigs.size());
+    strategies_ = createStrategies();
+    // Keys created once here: the detection thread never sees the map change
+    for (const auto& strategy : strategies_) {
+        publishedBalance_.try_emplace(strategy->startingAsset());
+    }
+
+    if (config.exchangeInfoRefreshSec > 0) {
+        if (replayFeeder_) {
+            LOG_WARNING("[Runner] exchangeInfoRefreshSec ignored in replay");
+        } else {
+            LOG_INFO("[Runner] Creating Admin for exchange info refresh every {}s", config.exchangeInfoRefreshSec);
+            refreshAdmin_ = std::make_unique<Admin>(config.restEndpoint, config.apiKey, *key_);
+        }
+    }
 
     LOG_INFO("[Runner] Creating TradePersistence in: {}", config.tradeLogDir);
     tradePersistence_ = std::make_unique<TradePersistence>(config.tradeLogDir);
 }
 
+Runner::~Runner() {
+    stopExecutionThread();
+    if (broker_) {
+        broker_->setOrderListener(nullptr);
+    }
+    stopExchangeInfoRefresh();
+    delete pendingGeneration_.exchange(nullptr);
+    freeRetiredGenerations();
+}
+
+std::vector<std::unique_ptr<TriangularArbitrage>> Runner::createStrategies() const {
+    std::vector<std::unique_ptr<TriangularArbitrage>> strategies;
+    for (const auto& strategyConfig : config_.strategyConfigs) {
+        auto strategy = std::make_unique<TriangularArbitrage>(strategyConfig);
+        strategy->setDepthBook(depthBook_.get());
+        strategies.push_back(std::move(strategy));
+    }
+    return strategies;
+}
+
 void Runner::initialize() {
     LOG_INFO("[Runner] Initializing...");
 
-    symbolsList_ = admin_->fetchExchangeInfo();
+    const nlohmann::json exchangeInfo = (replayFeeder_ && !config_.replayExchangeInfoFile.empty())
+        ? Admin::readExchangeInfoFile(config_.replayExchangeInfoFile)
+        : admin_->fetchExchangeInfoJson();
+
+    std::vector<std::string> startingAssets;
+    for (const auto& strategy : strategies_) {
+        startingAssets.push_back(strategy->startingAsset());
+    }
+
+    // Warm restart: same exchange info and assets -> no parsing, no discovery
+    std::optional<RouteCache> routeCache;
+    uint64_t cacheKey = 0;
+    std::vector<std::vector<RouteDescriptor>> cachedRoutes;
+    bool cacheHit = false;
+    if (!config_.routeCacheFile.empty() || refreshAdmin_) {
+        cacheKey = RouteCache::computeKey(exchangeInfo, startingAssets);
+    }
+    if (!config_.routeCacheFile.empty()) {
+        routeCache.emplace(config_.routeCacheFile);
+        cacheHit = routeCache->load(cacheKey, startingAssets, symbolsList_, cachedRoutes);
+    }
+    if (!cacheHit) {
+        symbolsList_ = Admin::parseExchangeInfo(exchangeInfo);
+    }
+    LOG_INFO("[Runner] {} symbols from exchange info", symbolsList_.size());
 
     orderSizer_.clear();
     for (const auto& symbol : symbolsList_) {
         orderSizer_.addSymbol(symbol.to_str(), symbol.getFilters());
     }
 
-    strategy_->discoverRoutes(symbolsList_);
+    // Earlier instances claim shared cycles; one subscription covers all
+    std::set<std::string> claimedCycles;
+    std::set<std::string> strategySymbols;
+    for (size_t i = 0; i < strategies_.size(); ++i) {
+        auto& strategy = strategies_[i];
+        if (cacheHit) {
+            strategy->loadRoutes(symbolsList_, std::move(cachedRoutes[i]));
+        } else {
+            strategy->discoverRoutes(symbolsList_, strategies_.size() > 1 ? &claimedCycles : nullptr);
+        }
+        strategySymbols.insert(strategy->subscribedSymbols().begin(), strategy->subscribedSymbols().end());
+    }
+
+    if (routeCache && !cacheHit) {
+        std::vector<std::vector<RouteDescriptor>> routes;
+        for (const auto& strategy : strategies_) {
+            routes.push_back(strategy->routes());
+        }
+        routeCache->save(cacheKey, startingAssets, symbolsList_, routes);
+    }
+
+    if (replayFeeder_) {
+        // No FIX sessions and no account: the journal drives the book
+        balance_.clear();
+        for (const auto& strategy : strategies_) {
+            const auto& asset = strategy->startingAsset();
+            auto it = config_.replayBalances.find(asset);
+            balance_[asset] = (it != config_.replayBalances.end()) ? it->second : config_.replayBalance;
+            LOG_INFO("[Runner] Replay {} balance: {}", asset, balance_[asset]);
+        }
+        publishBalances();
+
+        subscribedMask_.reset();
+        for (const auto& symbol : strategySymbols) {
+            subscribedMask_.set(SymbolRegistry::instance().registerSymbol(symbol));
+        }
+
+        LOG_INFO("[Runner] Replay initialization complete");
+        LOG_INFO("[Runner] Polling mode: {}", pollingModeName(config_.pollingMode));
+        return;
+    }
 
     balance_ = admin_->fetchAccountBalances();
 
-    const auto& startingAsset = strategy_->startingAsset();
-    if (balance_.find(startingAsset) == balance_.end()) {
-        LOG_WARNING("[Runner] No balance found for starting asset: {}", startingAsset);
-        balance_[startingAsset] = 0.0;
-    } else {
-        LOG_INFO("[Runner] Starting asset {} balance: {}", startingAsset, balance_[startingAsset]);
+    if (config_.executionMode == ExecutionMode::Parallel) {
+        inventoryTarget_ = balance_;
+        LOG_INFO("[Runner] Parallel execution: {} asset(s) held as inventory, rebalance beyond {:.0f}% drift",
+                 inventoryTarget_.size(), config_.rebalanceThreshold * 100.0);
+    }
+
+    for (const auto& strategy : strategies_) {
+        const auto& startingAsset = strategy->startingAsset();
+        if (balance_.find(startingAsset) == balance_.end()) {
+            LOG_WARNING("[Runner] No balance found for starting asset: {}", startingAsset);
+            balance_[startingAsset] = 0.0;
+        } else {
+            LOG_INFO("[Runner] Starting asset {} balance: {}", startingAsset, balance_[startingAsset]);
+        }
     }
+    publishBalances();
 
     LOG_INFO("[Runner] Connecting FIX sessions...");
     feeder_->connect();
@@ -58,36 +249,214 @@ void Runner::initialize() {
     LOG_INFO("[Runner] FIX sessions connected");
 
     // Subscribe only to symbols that are part of arbitrage paths
-    const auto& strategySymbols = strategy_->subscribedSymbols();
     if (!strategySymbols.empty()) {
         std::vector<std::string> symbolsToSubscribe(strategySymbols.begin(), strategySymbols.end());
 
         LOG_INFO("[Runner] Subscribing to market data for {} symbols (out of {} total)",
                  symbolsToSubscribe.size(), symbolsList_.size());
         feeder_->subscribeToSymbols(symbolsToSubscribe);
+        broker_->prepareOrderTemplates(symbolsToSubscribe);
+
+        subscribedMask_.reset();
+        for (const auto& symbol : symbolsToSubscribe) {
+            subscribedMask_.set(SymbolRegistry::instance().getId(symbol));
+        }
 
         waitForMarketDataSnapshots();
     } else {
         LOG_WARNING("[Runner] No arbitrage paths found, no symbols to subscribe to");
     }
 
+    if (refreshAdmin_) {
+        startExchangeInfoRefresh(cacheKey, std::move(strategySymbols));
+    }
+
     LOG_INFO("[Runner] Initialization complete");
-    LOG_INFO("[Runner] Polling mode: {}",
-             config_.pollingMode == PollingMode::Blocking ? "Blocking" :
-             config_.pollingMode == PollingMode::BusyPoll ? "BusyPoll" : "Hybrid");
+    LOG_INFO("[Runner] Polling mode: {}", pollingModeName(config_.pollingMode));
 }
 
 void Runner::shutdown() {
     LOG_INFO("[Runner] Shutting down...");
 
+    stopExchangeInfoRefresh();
+
+    stopExecutionThread();
+
+    if (pipelines_ && pipelines_->anyBusy()) {
+        LOG_CRITICAL("[Runner] Shutting down with an arbitrage in flight - check open positions");
+    }
+
     if (feeder_) {
         feeder_->disconnect();
     }
-    if (broker_) {
+    if (broker_ && !replayFeeder_) {
         broker_->disconnect();
     }
 }
 
+void Runner::startExchangeInfoRefresh(uint64_t key, std::set<std::string> subscribed) {
+    refreshKey_ = key;
+    refreshSymbols_.clear();
+    for (const auto& symbol : symbolsList_) {
+        refreshSymbols_.insert(symbol.to_str());
+    }
+    refreshSubscribed_ = std::move(subscribed);
+
+    LOG_INFO("[Runner] Refreshing exchange info every {}s", config_.exchangeInfoRefreshSec);
+    refreshThread_ = std::thread(&Runner::refreshLoop, this);
+}
+
+void Runner::stopExchangeInfoRefresh() {
+    if (!refreshThread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(refreshMtx_);
+        refreshStop_ = true;
+    }
+    refreshCv_.notify_all();
+    refreshThread_.join();
+}
+
+void Runner::refreshLoop() {
+    const auto interval = std::chrono::seconds(config_.exchangeInfoRefreshSec);
+
+    std::unique_lock<std::mutex> lock(refreshMtx_);
+    while (!refreshCv_.wait_for(lock, interval, [this] { return refreshStop_; })) {
+        lock.unlock();
+        try {
+            refreshExchangeInfo();
+        } catch (const std::exception& e) {
+            // Keep trading on the current generation, retry next period
+            LOG_ERROR("[Runner] Exchange info refresh failed: {}", e.what());
+        }
+        lock.lock();
+    }
+}
+
+void Runner::refreshExchangeInfo() {
+    // Generations replaced since the last run: no longer reachable from the detection thread
+    freeRetiredGenerations();
+
+    const nlohmann::json exchangeInfo = refreshAdmin_->fetchExchangeInfoJson();
+
+    std::vector<std::string> startingAssets;
+    for (const auto& strategyConfig : config_.strategyConfigs) {
+        startingAssets.push_back(strategyConfig.startingAsset);
+    }
+    const uint64_t key = RouteCache::computeKey(exchangeInfo, startingAssets);
+    if (key == refreshKey_) {
+        LOG_DEBUG("[Runner] Exchange info unchanged");
+        return;
+    }
+
+    std::vector<fin::Symbol> symbols = Admin::parseExchangeInfo(exchangeInfo);
+
+    std::set<std::string> listed;
+    for (const auto& symbol : symbols) {
+        listed.insert(symbol.to_str());
+    }
+    size_t added = 0;
+    for (const auto& name : listed) {
+        added += refreshSymbols_.count(name) == 0;
+    }
+    size_t removed = 0;
+    for (const auto& name : refreshSymbols_) {
+        removed += listed.count(name) == 0;
+    }
+    LOG_INFO("[Runner] Exchange info changed: {} symbols ({} listed, {} removed), rebuilding routes",
+             symbols.size(), added, removed);
+
+    // Same construction as initialize(), on this thread and into fresh objects
+    auto generation = std::make_unique<StrategyGeneration>();
+    generation->strategies = createStrategies();
+
+    std::set<std::string> claimedCycles;
+    std::set<std::string> strategySymbols;
+    for (auto& strategy : generation->strategies) {
+        strategy->discoverRoutes(symbols, generation->strategies.size() > 1 ? &claimedCycles : nullptr);
+        strategySymbols.insert(strategy->subscribedSymbols().begin(), strategy->subscribedSymbols().end());
+    }
+
+    for (const auto& symbol : symbols) {
+        generation->orderSizer.addSymbol(symbol.to_str(), symbol.getFilters());
+    }
+    for (const auto& symbol : strategySymbols) {
+        generation->subscribedMask.set(SymbolRegistry::instance().registerSymbol(symbol));
+    }
+
+    // Subscribe before publishing so the new legs have quotes once adopted.
+    // Symbols that left every path stay subscribed: Feeder unsubscribes whole
+    // requests, and their ticks no longer reach any path.
+    std::vector<std::string> newSymbols;
+    for (const auto& symbol : strategySymbols) {
+        if (refreshSubscribed_.count(symbol) == 0) {
+            newSymbols.push_back(symbol);
+        }
+    }
+    if (!newSymbols.empty()) {
+        LOG_INFO("[Runner] Subscribing to market data for {} new symbol(s)", newSymbols.size());
+        feeder_->subscribeToSymbols(newSymbols);
+        broker_->prepareOrderTemplates(newSymbols);
+        refreshSubscribed_.insert(newSymbols.begin(), newSymbols.end());
+    }
+
+    if (!config_.routeCacheFile.empty()) {
+        std::vector<std::vector<RouteDescriptor>> routes;
+        for (const auto& strategy : generation->strategies) {
+            routes.push_back(strategy->routes());
+        }
+        RouteCache(config_.routeCacheFile).save(key, startingAssets, symbols, routes);
+    }
+
+    generation->symbols = std::move(symbols);
+
+    // An older generation the detection thread never picked up is dropped
+    delete pendingGeneration_.exchange(generation.release(), std::memory_order_acq_rel);
+
+    refreshKey_ = key;
+    refreshSymbols_ = std::move(listed);
+}
+
+bool Runner::adoptPendingGeneration() {
+    std::unique_ptr<StrategyGeneration> generation(pendingGeneration_.exchange(nullptr, std::memory_order_acq_rel));
+    if (!generation) {
+        return false;
+    }
+
+    {
+        // The execution thread reads them for rebalance orders
+        std::lock_guard<std::mutex> lock(generationMtx_);
+        strategies_.swap(generation->strategies);
+        symbolsList_.swap(generation->symbols);
+        std::swap(orderSizer_, generation->orderSizer);
+        std::swap(subscribedMask_, generation->subscribedMask);
+    }
+
+    LOG_INFO("[Runner] Switched to refreshed exchange info ({} symbols)", symbolsList_.size());
+
+    // The refresher frees the old state on its next run. Several adoptions
+    // can land between two of its runs; none of them is freed here.
+    while (!unreturnedGenerations_.empty() &&
+           retiredGenerations_.tryPush(unreturnedGenerations_.back().get())) {
+        unreturnedGenerations_.back().release();
+        unreturnedGenerations_.pop_back();
+    }
+    if (retiredGenerations_.tryPush(generation.get())) [[likely]] {
+        generation.release();
+    } else {
+        unreturnedGenerations_.push_back(std::move(generation));
+    }
+    return true;
+}
+
+void Runner::freeRetiredGenerations() {
+    StrategyGeneration* retired = nullptr;
+    while (retiredGenerations_.tryPop(retired)) {
+        delete retired;
+    }
+}
+
 void Runner::waitForMarketDataSnapshots() {
     LOG_INFO("[Runner] Waiting for market data snapshots...");
 
@@ -101,214 +470,501 @@ void Runner::waitForMarketDataSnapshots() {
     }
 }
 
-void Runner::handleExecutionFailure(int legIndex, const std::string& clOrdId, const std::string& reason,
-                                    const std::vector<ExecutedOrder>& executedOrders) {
+void Runner::handleExecutionFailure(size_t slot, const PipelineResult& result, std::vector<PlannedLeg> rollbackLegs) {
     LOG_CRITICAL("[Runner] ========== EXECUTION FAILURE ==========");
-    LOG_CRITICAL("[Runner] Failed at leg {}: {}", legIndex + 1, reason);
-
-    // Execute rollback for previously successful orders
-    if (!executedOrders.empty()) {
-        LOG_WARNING("[Runner] Initiating rollback for {} executed order(s)", executedOrders.size());
-        bool rollbackSuccess = executeRollback(executedOrders);
-        if (rollbackSuccess) {
-            LOG_INFO("[Runner] Rollback completed successfully");
-        } else {
-            LOG_CRITICAL("[Runner] ROLLBACK PARTIALLY FAILED - manual intervention required");
+    LOG_CRITICAL("[Runner] Failed at leg {}: {}", result.failedLeg + 1, result.reason);
+    LOG_CRITICAL("[Runner] No new arbitrage is started; shutting down once every pipeline has settled");
+    executionFailed_ = true;
+
+    if (rollbackLegs.empty()) {
+        LOG_INFO("[Runner] No orders to rollback (failed on first leg)");
+        if (!replayFeeder_) {
+            balance_ = admin_->fetchAccountBalances();
         }
+        LOG_CRITICAL("[Runner] ==========================================");
+        return;
+    }
+
+    // Assets stay locked until the last reversing order has settled
+    LOG_WARNING("[Runner] Initiating rollback for {} executed order(s)", rollbackLegs.size());
+    LOG_WARNING("[Runner] ========== EXECUTING ROLLBACK ==========");
+    rollbacks_[slot] = {std::move(rollbackLegs), 0, true};
+    sendRollbackLeg(slot);
+}
+
+void Runner::sendRollbackLeg(size_t slot) {
+    const InFlightRollback& rollback = rollbacks_[slot];
+    const PlannedLeg& leg = rollback.legs.back();
+    const char* sideStr = (leg.side == FIX::OE::Side_BUY) ? "BUY" : "SELL";
+    const char* origSideStr = (leg.side == FIX::OE::Side_BUY) ? "SELL" : "BUY";
+
+    if (rollback.retries > 0) {
+        LOG_WARNING("[Runner] Rollback retry {} for {}", rollback.retries, leg.symbol);
+    }
+    LOG_WARNING("[Runner] Rollback: {} {} qty={:.8f} (original was {} @ {:.8f})",
+                sideStr, leg.symbol, leg.qty, origSideStr, leg.estPrice);
+
+    (*pipelines_)[slot].start({leg}, false, ROLLBACK_TIMEOUT_MS);
+}
+
+void Runner::finishRollbackLeg(size_t slot, const PipelineResult& result) {
+    InFlightRollback& rollback = rollbacks_[slot];
+    const PlannedLeg& leg = result.legs.front();
+    const LegFill& fill = result.fills.front();
+
+    if (!result.failed) {
+        LOG_INFO("[Runner] Rollback FILLED: clOrdId={}, qty={:.8f}, avgPx={:.8f}",
+                 fill.clOrdId, fill.filledQty, fill.avgPrice);
+    } else if (fill.filledQty > 0) {
+        // Partial fill - warn but consider it a success
+        LOG_WARNING("[Runner] Rollback PARTIAL: clOrdId={}, requested={:.8f}, filled={:.8f} ({:.1f}%)",
+                    fill.clOrdId, fill.sentQty, fill.filledQty, fill.filledQty / fill.sentQty * 100.0);
     } else {
-        LOG_INFO("[Runner] No orders to rollback (failed on first leg)");
+        LOG_ERROR("[Runner] Rollback FAILED: clOrdId={}, {}", fill.clOrdId, result.reason);
+        if (rollback.retries < MAX_ROLLBACK_RETRIES) {
+            ++rollback.retries;
+            sendRollbackLeg(slot);
+            return;
+        }
+        LOG_CRITICAL("[Runner] ROLLBACK FAILED for {} {} qty={:.8f}",
+                     (leg.side == FIX::OE::Side_BUY) ? "BUY" : "SELL", leg.symbol, leg.qty);
+        rollback.complete = false;
+        // Continue attempting other rollbacks - don't abort early
+    }
+
+    rollback.legs.pop_back();
+    rollback.retries = 0;
+    if (!rollback.legs.empty()) {
+        sendRollbackLeg(slot);
+        return;
+    }
+
+    LOG_WARNING("[Runner] ========== ROLLBACK {} ==========",
+                rollback.complete ? "COMPLETE" : "INCOMPLETE");
+    if (!rollback.complete) {
+        LOG_CRITICAL("[Runner] ROLLBACK PARTIALLY FAILED - manual intervention required");
     }
 
     // Refresh balance after rollback attempts
-    balance_ = admin_->fetchAccountBalances();
+    if (!replayFeeder_) {
+        balance_ = admin_->fetchAccountBalances();
+    }
+}
 
-    LOG_CRITICAL("[Runner] ==========================================");
-    throw ArbitrageExecutionError(reason, legIndex, clOrdId);
+double Runner::stakeFor(const TriangularArbitrage& strategy) const {
+    auto it = publishedBalance_.find(strategy.startingAsset());
+    const double balance = it != publishedBalance_.end() ? it->second.load(std::memory_order_relaxed) : 0.0;
+    return balance > 0 ? strategy.risk() * balance : 0.0;
 }
 
-bool Runner::executeRollback(const std::vector<ExecutedOrder>& executedOrders) {
-    LOG_WARNING("[Runner] ========== EXECUTING ROLLBACK ==========");
+void Runner::publishBalances() {
+    for (auto& [asset, published] : publishedBalance_) {
+        auto it = balance_.find(asset);
+        published.store(it != balance_.end() ? it->second : 0.0, std::memory_order_relaxed);
+    }
+}
+
+bool Runner::hasTradableBalance() const {
+    for (const auto& strategy : strategies_) {
+        if (stakeFor(*strategy) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TriangularArbitrage& Runner::strategyFor(const std::string& startingAsset) {
+    for (auto& strategy : strategies_) {
+        if (strategy->startingAsset() == startingAsset) {
+            return *strategy;
+        }
+    }
+    throw std::runtime_error("Runner: no strategy for starting asset " + startingAsset);
+}
+
+std::optional<Signal> Runner::detectUpdates(const UpdateMask& updatedSymbols) {
+    if (strategies_.size() == 1) [[likely]] {
+        auto& strategy = *strategies_.front();
+        return strategy.onMarketDataUpdate(updatedSymbols, orderBook_, stakeFor(strategy), orderSizer_);
+    }
+
+    std::optional<Signal> best;
+    for (auto& strategy : strategies_) {
+        auto sig = strategy->onMarketDataUpdate(updatedSymbols, orderBook_, stakeFor(*strategy), orderSizer_);
+        if (sig.has_value() && (!best.has_value() || returnOnStake(*sig) > returnOnStake(*best))) [[unlikely]] {
+            best = std::move(sig);
+        }
+    }
+    return best;
+}
 
-    bool allRollbacksSucceeded = true;
-    constexpr int ROLLBACK_TIMEOUT_MS = 10000;  // Longer timeout for rollback orders
-    constexpr int MAX_ROLLBACK_RETRIES = 1;     // Only retry once to avoid infinite loops
+std::optional<Signal> Runner::detectSymbol(SymbolId symbolId) {
+    if (strategies_.size() == 1) [[likely]] {
+        auto& strategy = *strategies_.front();
+        return strategy.onSymbolUpdate(symbolId, orderBook_, stakeFor(strategy), orderSizer_);
+    }
 
-    // Process rollbacks in reverse order (LIFO) to properly unwind the position
-    for (auto it = executedOrders.rbegin(); it != executedOrders.rend(); ++it) {
-        const auto& executed = *it;
+    std::optional<Signal> best;
+    for (auto& strategy : strategies_) {
+        auto sig = strategy->onSymbolUpdate(symbolId, orderBook_, stakeFor(*strategy), orderSizer_);
+        if (sig.has_value() && (!best.has_value() || returnOnStake(*sig) > returnOnStake(*best))) [[unlikely]] {
+            best = std::move(sig);
+        }
+    }
+    return best;
+}
 
-        // Determine opposite side: BUY ('1') -> SELL ('2'), SELL ('2') -> BUY ('1')
-        char rollbackSide = (executed.side == FIX::OE::Side_BUY) ? FIX::OE::Side_SELL : FIX::OE::Side_BUY;
-        const char* sideStr = (rollbackSide == FIX::OE::Side_BUY) ? "BUY" : "SELL";
-        const char* origSideStr = (executed.side == FIX::OE::Side_BUY) ? "BUY" : "SELL";
+std::unique_ptr<Runner::PlannedArbitrage> Runner::planArbitrage(const Signal& signal) {
+    auto arbitrage = std::make_unique<PlannedArbitrage>();
+    // Cycles start and end in the starting asset of the instance that found them
+    arbitrage->startingAsset = signal.orders.front().getStartingAsset();
+    arbitrage->description = signal.description;
+    arbitrage->pnl = signal.pnl;
+    arbitrage->detectTsc = readTsc();
 
-        LOG_WARNING("[Runner] Rollback: {} {} qty={:.8f} (original was {} @ {:.8f})",
-                    sideStr, executed.symbol, executed.filledQty,
-                    origSideStr, executed.avgPrice);
+    const auto& strategy = strategyFor(arbitrage->startingAsset);
+    arbitrage->legs.reserve(signal.orders.size());
+    for (const auto& order : signal.orders) {
+        const std::string symbol = order.getSymbol().to_str();
+        arbitrage->legs.push_back({
+            .symbol = symbol,
+            .symbolId = SymbolRegistry::instance().getId(symbol),
+            .way = order.getWay(),
+            .side = (order.getWay() == Way::BUY) ? FIX::OE::Side_BUY : FIX::OE::Side_SELL,
+            .estPrice = order.getPrice(),
+            .qty = order.getQty(),
+            .feeRate = strategy.getFeeForSymbol(symbol) / 100.0,
+            .filters = order.getSymbol().getFilters()
+        });
+        // Each leg spends its input asset; the last one returns to the first
+        arbitrage->assets.push_back(order.getStartingAsset());
+    }
+    return arbitrage;
+}
 
-        bool rollbackSucceeded = false;
-        int retryCount = 0;
+void Runner::submitSignal(const Signal& signal) {
+    auto arbitrage = planArbitrage(signal);
 
-        while (!rollbackSucceeded && retryCount <= MAX_ROLLBACK_RETRIES) {
-            if (retryCount > 0) {
-                LOG_WARNING("[Runner] Rollback retry {} for {}", retryCount, executed.symbol);
+    if (!executionThread_.joinable()) {
+        // Replay: executed in journal order, simulated fills complete inline
+        if (!executionFailed_) {
+            executeArbitrage(*arbitrage);
+            collectExecution();
+        }
+        if (executionFailed_) [[unlikely]] {
+            // Simulated fills complete inline: the rollback legs settle here
+            while (pipelines_->anyBusy()) {
+                collectExecution();
             }
+            requestShutdown();
+        }
+        return;
+    }
 
-            // Use the original fill price as estimate for the rollback
-            std::string rollbackClOrdId = broker_->sendMarketOrder(
-                executed.symbol,
-                rollbackSide,
-                executed.filledQty,
-                executed.avgPrice
-            );
-
-            auto status = broker_->waitForOrderCompletion(rollbackClOrdId, ROLLBACK_TIMEOUT_MS);
-
-            if (status == OrderStatus::FILLED) {
-                auto rollbackState = broker_->getOrderState(rollbackClOrdId);
-
-                // Check for partial fills - warn but consider it a success if mostly filled
-                double fillRatio = rollbackState.cumQty / executed.filledQty;
-                if (fillRatio < 0.99) {
-                    LOG_WARNING("[Runner] Rollback PARTIAL: clOrdId={}, requested={:.8f}, filled={:.8f} ({:.1f}%)",
-                                rollbackClOrdId, executed.filledQty, rollbackState.cumQty, fillRatio * 100.0);
-                } else {
-                    LOG_INFO("[Runner] Rollback FILLED: clOrdId={}, qty={:.8f}, avgPx={:.8f}",
-                             rollbackClOrdId, rollbackState.cumQty, rollbackState.avgPx);
-                }
-                rollbackSucceeded = true;
+    if (!signalQueue_->tryPush(arbitrage.get())) [[unlikely]] {
+        LOG_WARNING("[Runner] Signal queue full, dropping signal: {}", signal.description);
+        return;
+    }
+    arbitrage.release();  // Owned by the execution thread
+}
 
-            } else if (status == OrderStatus::REJECTED) {
-                auto rollbackState = broker_->getOrderState(rollbackClOrdId);
-                LOG_ERROR("[Runner] Rollback REJECTED: clOrdId={}, reason={}",
-                          rollbackClOrdId, rollbackState.rejectReason);
+void Runner::startExecutionThread() {
+    executionStop_.store(false, std::memory_order_relaxed);
+    executionThread_ = std::thread(&Runner::executionLoop, this);
+}
 
-            } else if (status == OrderStatus::UNKNOWN) {
-                LOG_ERROR("[Runner] Rollback TIMEOUT: clOrdId={} - status unknown after {}ms",
-                          rollbackClOrdId, ROLLBACK_TIMEOUT_MS);
+void Runner::stopExecutionThread() {
+    if (!executionThread_.joinable()) {
+        return;
+    }
+    executionStop_.store(true, std::memory_order_release);
+    executionThread_.join();
 
-            } else {
-                LOG_ERROR("[Runner] Rollback FAILED: clOrdId={}, status={}",
-                          rollbackClOrdId, static_cast<int>(status));
+    PlannedArbitrage* arbitrage = nullptr;
+    while (signalQueue_->tryPop(arbitrage)) {
+        delete arbitrage;
+    }
+}
+
+void Runner::executionLoop() {
+    LOG_INFO("[Runner] Execution thread started ({} pipeline(s))", pipelines_->size());
+
+    int idleSpins = 0;
+    while (!executionStop_.load(std::memory_order_acquire)) {
+        try {
+            PlannedArbitrage* popped = nullptr;
+            if (signalQueue_->tryPop(popped)) {
+                std::unique_ptr<PlannedArbitrage> arbitrage(popped);
+                if (!executionFailed_) [[likely]] {
+                    executeArbitrage(*arbitrage);
+                }
+                idleSpins = 0;
             }
 
-            ++retryCount;
-        }
+            // Legs run on the FIX thread; pick up finished arbitrages between signals
+            collectExecution();
 
-        if (!rollbackSucceeded) {
-            LOG_CRITICAL("[Runner] ROLLBACK FAILED for {}: {} {} qty={:.8f}",
-                         executed.clOrdId, sideStr, executed.symbol, executed.filledQty);
-            allRollbacksSucceeded = false;
-            // Continue attempting other rollbacks - don't abort early
+            if (executionFailed_ && !pipelines_->anyBusy()) [[unlikely]] {
+                LOG_CRITICAL("[Runner] Every pipeline settled after the execution failure - shutting down");
+                requestShutdown();
+                break;
+            }
+
+            if (popped == nullptr && ++idleSpins >= config_.busyPollSpinCount) {
+                idleSpins = 0;
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+#ifdef __x86_64__
+            else if (popped == nullptr) {
+                _mm_pause();
+            }
+#endif
+        } catch (const std::exception& e) {
+            // Arbitrages may still be in flight: stop taking signals, keep collecting
+            LOG_ERROR("[Runner] Error in execution thread: {}", e.what());
+            executionFailed_ = true;
         }
     }
 
-    LOG_WARNING("[Runner] ========== ROLLBACK {} ==========",
-                allRollbacksSucceeded ? "COMPLETE" : "INCOMPLETE");
+    // Stopped from outside: what is in flight is still settled (or rolled back)
+    while (pipelines_->anyBusy()) {
+        collectExecution();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
 
-    return allRollbacksSucceeded;
+    LOG_INFO("[Runner] Execution thread stopped");
 }
 
-void Runner::executeArbitrage(const Signal& signal) {
-    const auto& startingAsset = strategy_->startingAsset();
+void Runner::executeArbitrage(PlannedArbitrage& arbitrage) {
+    const size_t slot = pipelines_->findIdle();
+    if (slot == pipelines_->size()) {
+        LOG_DEBUG("[Runner] All pipelines busy, skipping signal: {}", arbitrage.description);
+        return;
+    }
+    if (!assetLocks_.tryLock(arbitrage.assets)) {
+        LOG_DEBUG("[Runner] Asset in use by an arbitrage in flight, skipping signal: {}", arbitrage.description);
+        return;
+    }
+
+    const std::string& startingAsset = arbitrage.startingAsset;
 
     LOG_INFO("[Runner] ========== EXECUTING ARBITRAGE ==========");
     LOG_INFO("[Runner] Mode: {}", config_.liveMode ? "LIVE" : "TEST");
-    LOG_INFO("[Runner] Path: {}", signal.description);
-    LOG_INFO("[Runner] Theoretical PnL: {:.8f}", signal.pnl);
+    LOG_INFO("[Runner] Path: {}", arbitrage.description);
+    LOG_INFO("[Runner] Theoretical PnL: {:.8f}", arbitrage.pnl);
     LOG_INFO("[Runner] {} Balance: {:.8f}", startingAsset, balance_[startingAsset]);
+    LOG_INFO("[Runner] Pipeline: {}, signal-to-send={} ticks", slot, readTsc() - arbitrage.detectTsc);
+
+    const bool parallel = config_.executionMode == ExecutionMode::Parallel && inventoryCovers(arbitrage);
+    LOG_INFO("[Runner] Legs: {}", parallel ? "parallel (from inventory)" : "sequential");
+
+    for (size_t leg = 0; leg < arbitrage.legs.size(); ++leg) {
+        const auto& planned = arbitrage.legs[leg];
+        LOG_INFO("[Runner] Leg {}: {} {} @ MARKET, estPrice={:.8f}, qty={:.8f}",
+                 leg + 1, (planned.side == FIX::OE::Side_BUY ? "BUY" : "SELL"), planned.symbol,
+                 planned.estPrice, planned.qty);
+    }
+
+    inFlight_[slot] = {startingAsset, arbitrage.description, arbitrage.pnl, balance_[startingAsset],
+                       parallel, false, arbitrage.assets};
+    (*pipelines_)[slot].start(std::move(arbitrage.legs), parallel);
+}
+
+bool Runner::inventoryCovers(const PlannedArbitrage& arbitrage) const {
+    for (size_t leg = 0; leg < arbitrage.legs.size(); ++leg) {
+        const auto& planned = arbitrage.legs[leg];
+        const double needed = planned.way == Way::BUY ? planned.qty * planned.estPrice : planned.qty;
+        auto it = balance_.find(arbitrage.assets[leg]);
+        if (it == balance_.end() || it->second < needed * PARALLEL_BALANCE_HEADROOM) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Runner::collectExecution() {
+    bool finished = false;
+    for (size_t slot = 0; slot < pipelines_->size(); ++slot) {
+        auto result = (*pipelines_)[slot].poll();
+        if (!result.has_value()) [[likely]] {
+            continue;
+        }
+        finished = true;
+        InFlightArbitrage& inFlight = inFlight_[slot];
+        try {
+            if (!rollbacks_[slot].legs.empty()) [[unlikely]] {
+                finishRollbackLeg(slot, *result);
+            } else if (inFlight.rebalance) {
+                finishRebalance(*result);
+            } else {
+                finishArbitrage(slot, *result);
+            }
+        } catch (const std::exception& e) {
+            LOG_CRITICAL("[Runner] Error collecting pipeline {} ({}): {} - check open positions",
+                         slot, inFlight.description, e.what());
+            executionFailed_ = true;
+        }
+        // A rollback in flight keeps the assets of its arbitrage
+        if (!(*pipelines_)[slot].busy()) {
+            assetLocks_.unlock(inFlight.assets);
+        }
+        publishBalances();
+    }
+
+    if (finished && rebalanceDue_ && !executionFailed_ && !executionStop_.load(std::memory_order_relaxed) &&
+        pipelines_->findIdle() != pipelines_->size()) [[unlikely]] {
+        rebalanceInventory();
+    }
+}
+
+void Runner::rebalanceInventory() {
+    rebalanceDue_ = false;
+    const size_t slot = pipelines_->findIdle();
+
+    std::lock_guard<std::mutex> lock(generationMtx_);
+    for (const auto& [asset, target] : inventoryTarget_) {
+        const bool isStartingAsset = std::any_of(strategies_.begin(), strategies_.end(),
+            [&](const auto& strategy) { return strategy->startingAsset() == asset; });
+        if (target <= 0 || isStartingAsset) {
+            continue;  // Starting assets accumulate the pnl, they have no target
+        }
+        if (assetLocks_.isLocked(asset)) {
+            rebalanceDue_ = true;  // Looked at again once its arbitrage has settled
+            continue;
+        }
+
+        auto it = balance_.find(asset);
+        const double drift = (it != balance_.end() ? it->second : 0.0) - target;
+        if (std::abs(drift) <= target * config_.rebalanceThreshold) {
+            continue;
+        }
+
+        std::string counterAsset;
+        auto leg = planRebalanceLeg(asset, drift, counterAsset);
+        if (!leg.has_value()) {
+            LOG_WARNING("[Runner] Cannot rebalance {} (drift {:+.8f}): no tradable pair with a starting asset",
+                        asset, drift);
+            continue;
+        }
+
+        LOG_INFO("[Runner] Rebalancing {}: drift {:+.8f} of target {:.8f}, {} {} qty={:.8f}",
+                 asset, drift, target, leg->way == Way::BUY ? "BUY" : "SELL", leg->symbol, leg->qty);
+        std::vector<std::string> assets{asset, counterAsset};
+        if (!assetLocks_.tryLock(assets)) {
+            rebalanceDue_ = true;
+            continue;
+        }
+        inFlight_[slot] = {std::string(), "rebalance " + asset, 0.0, 0.0, false, true, std::move(assets)};
+        (*pipelines_)[slot].start({*leg});
+        return;  // The next asset is looked at once this one has settled
+    }
+}
+
+std::optional<PlannedLeg> Runner::planRebalanceLeg(const std::string& asset, double drift,
+                                                    std::string& counterAsset) const {
+    const double amount = std::abs(drift);
+
+    for (const auto& strategy : strategies_) {
+        const std::string& start = strategy->startingAsset();
+        for (const auto& symbol : symbolsList_) {
+            const bool assetIsBase = symbol.getBase() == asset && symbol.getQuote() == start;
+            const bool assetIsQuote = symbol.getBase() == start && symbol.getQuote() == asset;
+            if (!assetIsBase && !assetIsQuote) {
+                continue;
+            }
+
+            const SymbolId id = SymbolRegistry::instance().getId(symbol.to_str());
+            const BidAsk quote = id != INVALID_SYMBOL_ID ? orderBook_.get(id) : BidAsk{};
+            if (quote.bid <= 0 || quote.ask <= 0) {
+                continue;  // Not subscribed, no price to size with
+            }
+
+            // Short of the asset: acquire it; long: give it away
+            const bool buy = (drift < 0) == assetIsBase;
+            const double price = buy ? quote.ask : quote.bid;
+            const double qty = symbol.getFilters().roundMarketQty(assetIsBase ? amount : amount / price);
+
+            std::array<LegSize, 1> check{{{id, price, qty}}};
+            if (qty <= 0 || !orderSizer_.validateNotionals(check, true)) {
+                continue;
+            }
+
+            counterAsset = start;
+            return PlannedLeg{
+                .symbol = symbol.to_str(),
+                .symbolId = id,
+                .way = buy ? Way::BUY : Way::SELL,
+                .side = buy ? FIX::OE::Side_BUY : FIX::OE::Side_SELL,
+                .estPrice = price,
+                .qty = qty,
+                .feeRate = strategy->getFeeForSymbol(symbol.to_str()) / 100.0,
+                .filters = symbol.getFilters()
+            };
+        }
+    }
+    return std::nullopt;
+}
+
+void Runner::finishRebalance(const PipelineResult& result) {
+    const auto& fill = result.fills.front();
+    if (result.failed) {
+        // Not retried until the next parallel arbitrage: a failing pair would loop
+        LOG_ERROR("[Runner] Rebalance {} failed: {}", result.legs.front().symbol, result.reason);
+    } else {
+        LOG_INFO("[Runner] Rebalance {} FILLED clOrdId={}, qty={:.8f}, avgPx={:.8f}",
+                 result.legs.front().symbol, fill.clOrdId, fill.filledQty, fill.avgPrice);
+        rebalanceDue_ = true;
+    }
+
+    if (!replayFeeder_) {
+        balance_ = admin_->fetchAccountBalances();
+    }
+}
+
+void Runner::finishArbitrage(size_t slot, const PipelineResult& result) {
+    const InFlightArbitrage& inFlight = inFlight_[slot];
+    const std::string& startingAsset = inFlight.startingAsset;
+    if (inFlight.parallel) {
+        // Legs filled from inventory: the intermediate assets drifted by fees and rounding
+        rebalanceDue_ = true;
+    }
 
-    // Start persistence sequence for this arbitrage
+    // Persistence sequence for this arbitrage, written once the legs are done
     std::string parentTradeId = tradePersistence_->startArbitrageSequence();
-    const size_t totalLegs = signal.orders.size();
+    const size_t totalLegs = result.legs.size();
 
     std::vector<LegResult> results;
-    results.reserve(signal.orders.size());
+    results.reserve(totalLegs);
 
-    // Track executed orders for potential rollback
-    std::vector<ExecutedOrder> executedOrders;
-    executedOrders.reserve(signal.orders.size());
+    // Opposite order of each filled leg, for a potential rollback
+    std::vector<PlannedLeg> rollbackLegs;
+    rollbackLegs.reserve(totalLegs);
 
-    size_t legIndex = 0;
+    for (size_t legIndex = 0; legIndex < result.fills.size(); ++legIndex) {
+        const auto& leg = result.legs[legIndex];
+        const auto& fill = result.fills[legIndex];
+        if (fill.filledQty <= 0) {
+            continue;  // Not sent, or nothing filled
+        }
 
-    for (const auto& order : signal.orders) {
-        char side = (order.getWay() == Way::BUY) ? FIX::OE::Side_BUY : FIX::OE::Side_SELL;
-        std::string symbol = order.getSymbol().to_str();
-        double qty = order.getQty();
-        double estPrice = order.getPrice();
-        double feeRate = strategy_->getFeeForSymbol(symbol) / 100.0;
+        // Use the original fill price as estimate for the rollback
+        PlannedLeg& reverse = rollbackLegs.emplace_back(leg);
+        reverse.way = leg.way == Way::BUY ? Way::SELL : Way::BUY;
+        reverse.side = leg.side == FIX::OE::Side_BUY ? FIX::OE::Side_SELL : FIX::OE::Side_BUY;
+        reverse.estPrice = fill.avgPrice;
+        reverse.qty = fill.filledQty;
 
-        LOG_INFO("[Runner] Leg {}: {} {} @ MARKET, estPrice={:.8f}, qty={:.8f}",
-                 legIndex + 1, (side == FIX::OE::Side_BUY ? "BUY" : "SELL"), symbol, estPrice, qty);
-
-        std::string clOrdId = broker_->sendMarketOrder(symbol, side, qty, estPrice);
-
-        auto status = broker_->waitForOrderCompletion(clOrdId, 5000);
-
-        if (status == OrderStatus::REJECTED) {
-            auto orderState = broker_->getOrderState(clOrdId);
-            LOG_CRITICAL("[Runner] Leg {}: Order {} REJECTED: {}",
-                        legIndex + 1, clOrdId, orderState.rejectReason);
-            handleExecutionFailure(static_cast<int>(legIndex), clOrdId,
-                "Order rejected at leg " + std::to_string(legIndex + 1) + ": " + orderState.rejectReason,
-                executedOrders);
-        }
-
-        if (status == OrderStatus::UNKNOWN) {
-            LOG_CRITICAL("[Runner] Leg {}: Order {} TIMEOUT - status unknown",
-                        legIndex + 1, clOrdId);
-            handleExecutionFailure(static_cast<int>(legIndex), clOrdId,
-                "Order timeout at leg " + std::to_string(legIndex + 1) + " - manual intervention required",
-                executedOrders);
-        }
-
-        if (status != OrderStatus::FILLED) {
-            LOG_CRITICAL("[Runner] Leg {}: Order {} unexpected status={}",
-                        legIndex + 1, clOrdId, static_cast<int>(status));
-            handleExecutionFailure(static_cast<int>(legIndex), clOrdId,
-                "Order failed at leg " + std::to_string(legIndex + 1) + " with status " + std::to_string(static_cast<int>(status)),
-                executedOrders);
-        }
-
-        auto orderState = broker_->getOrderState(clOrdId);
-        double realPrice = orderState.avgPx;
-        double realQty = orderState.cumQty;
-
-        if (realQty < qty * 0.99) {
-            LOG_CRITICAL("[Runner] Leg {}: Order {} PARTIAL FILL: requested={:.8f}, filled={:.8f}",
-                        legIndex + 1, clOrdId, qty, realQty);
-            // For partial fills, still track what was executed for rollback
-            if (realQty > 0) {
-                executedOrders.push_back({
-                    .clOrdId = clOrdId,
-                    .symbol = symbol,
-                    .side = side,
-                    .filledQty = realQty,
-                    .avgPrice = realPrice
-                });
-            }
-            handleExecutionFailure(static_cast<int>(legIndex), clOrdId,
-                "Partial fill at leg " + std::to_string(legIndex + 1) + ": requested " +
-                std::to_string(qty) + ", filled " + std::to_string(realQty),
-                executedOrders);
+        if (fill.filledQty < fill.sentQty * 0.99) {
+            continue;  // Partial fill of a failed leg: rolled back, not reported as a trade
         }
 
-        double slippage = (estPrice > 0) ? ((realPrice - estPrice) / estPrice * 100.0) : 0.0;
+        double slippage = (leg.estPrice > 0) ? ((fill.avgPrice - leg.estPrice) / leg.estPrice * 100.0) : 0.0;
 
-        LOG_INFO("[Runner] Leg {}: FILLED clOrdId={}", legIndex + 1, clOrdId);
+        LOG_INFO("[Runner] Leg {}: FILLED clOrdId={}", legIndex + 1, fill.clOrdId);
         LOG_INFO("[Runner]   Est  Price: {:.8f} | Real Price: {:.8f} | Slippage: {:+.4f}%",
-                 estPrice, realPrice, slippage);
-        LOG_INFO("[Runner]   Est  Qty:   {:.8f} | Real Qty:   {:.8f}",
-                 qty, realQty);
-
-        // Track successful execution for potential rollback
-        executedOrders.push_back({
-            .clOrdId = clOrdId,
-            .symbol = symbol,
-            .side = side,
-            .filledQty = realQty,
-            .avgPrice = realPrice
-        });
+                 leg.estPrice, fill.avgPrice, slippage);
+        LOG_INFO("[Runner]   Sent Qty:   {:.8f} | Real Qty:   {:.8f}",
+                 fill.sentQty, fill.filledQty);
 
         // Determine trade type based on leg position
         TradeType tradeType = (legIndex == 0) ? TradeType::ENTRY :
@@ -317,31 +973,33 @@ void Runner::executeArbitrage(const Signal& signal) {
 
         // Record trade (PnL will be updated for EXIT trade after calculation)
         tradePersistence_->recordTrade(
-            clOrdId,
+            fill.clOrdId,
             parentTradeId,
             tradeType,
-            symbol,
-            (side == FIX::OE::Side_BUY) ? "BUY" : "SELL",
-            estPrice,
-            qty,
-            realPrice,
-            realQty,
+            leg.symbol,
+            (leg.side == FIX::OE::Side_BUY) ? "BUY" : "SELL",
+            leg.estPrice,
+            fill.sentQty,
+            fill.avgPrice,
+            fill.filledQty,
             TradeStatus::EXECUTED,
             0.0,  // PnL (updated later for EXIT)
             0.0   // PnL% (updated later for EXIT)
         );
 
-        results.push_back({symbol, order.getWay(), estPrice, realPrice, qty, realQty, feeRate});
-        ++legIndex;
+        results.push_back({leg.symbol, leg.way, leg.estPrice, fill.avgPrice, fill.sentQty, fill.filledQty, leg.feeRate});
+    }
+
+    if (result.failed) {
+        LOG_CRITICAL("[Runner] Leg {}: Order {} failed: {}", result.failedLeg + 1, result.failedClOrdId, result.reason);
+        handleExecutionFailure(slot, result, std::move(rollbackLegs));
+        return;
     }
 
     // Calculate and report PnL
     {
-        double balanceBefore = balance_[startingAsset];
-
-        balance_ = admin_->fetchAccountBalances();
-        double balanceAfter = balance_[startingAsset];
-        double actualPnl = balanceAfter - balanceBefore;
+        // Taken at start: another arbitrage may have refreshed balance_ since
+        double balanceBefore = inFlight.balanceBefore;
 
         double traceAmount = results[0].realQty;
         if (results[0].way == Way::BUY) {
@@ -358,29 +1016,51 @@ void Runner::executeArbitrage(const Signal& signal) {
         }
 
         double tracedPnl = traceAmount - initialStake;
+
+        if (replayFeeder_) {
+            // No account to query: the simulated balance moves by the traced PnL
+            balance_[startingAsset] = balanceBefore + tracedPnl;
+        } else {
+            balance_ = admin_->fetchAccountBalances();
+        }
+        double balanceAfter = balance_[startingAsset];
+        double actualPnl = balanceAfter - balanceBefore;
+
         double tracedPnlPct = (initialStake > 0) ? (tracedPnl / initialStake * 100.0) : 0.0;
         double actualPnlPct = (initialStake > 0) ? (actualPnl / initialStake * 100.0) : 0.0;
 
         LOG_INFO("[Runner] ========== EXECUTION SUMMARY ==========");
+        LOG_INFO("[Runner] Path: {}", inFlight.description);
         LOG_INFO("[Runner] {} Balance Before: {:.8f}", startingAsset, balanceBefore);
         LOG_INFO("[Runner] {} Balance After:  {:.8f}", startingAsset, balanceAfter);
         LOG_INFO("[Runner] Actual PnL:        {:.8f} ({:+.4f}%)", actualPnl, actualPnlPct);
         LOG_INFO("[Runner] Traced PnL:        {:.8f} ({:+.4f}%)", tracedPnl, tracedPnlPct);
-        LOG_INFO("[Runner] Theoretical PnL:   {:.8f}", signal.pnl);
+        LOG_INFO("[Runner] Theoretical PnL:   {:.8f}", inFlight.pnl);
         LOG_INFO("[Runner] ========================================");
     }
 }
 
 void Runner::run() {
-    LOG_INFO("[Runner] Starting main loop...");
+    if (replayFeeder_) {
+        runReplay();
+        return;
+    }
+
+    // Detection stays on this thread; signals are executed on their own thread
+    startExecutionThread();
 
-    const auto& startingAsset = strategy_->startingAsset();
-    const double risk = strategy_->risk();
+    if (config_.pollingMode == PollingMode::EventQueue) {
+        runEventQueue();
+        stopExecutionThread();
+        return;
+    }
+
+    LOG_INFO("[Runner] Starting main loop...");
 
     while (!shutdownRequested_.load(std::memory_order_acquire)) {
         try {
             // Wait for market data updates based on polling mode
-            std::bitset<MAX_SYMBOLS> updatedSymbols;
+            UpdateMask updatedSymbols;
 
             switch (config_.pollingMode) {
                 case PollingMode::Blocking:
@@ -399,18 +1079,22 @@ void Runner::run() {
                     break;
             }
 
-            auto balanceIt = balance_.find(startingAsset);
-            if (balanceIt == balance_.end() || balanceIt->second <= 0) [[unlikely]] {
-                LOG_CRITICAL("[Runner] No balance for starting asset '{}' - exiting", startingAsset);
-                return;
+            if (pendingGeneration_.load(std::memory_order_relaxed) != nullptr) [[unlikely]] {
+                // New instances have no cached prices yet: screen every subscribed symbol
+                if (adoptPendingGeneration()) {
+                    updatedSymbols = subscribedMask_;
+                }
+            }
+
+            if (!hasTradableBalance()) [[unlikely]] {
+                LOG_CRITICAL("[Runner] No balance for any starting asset - exiting");
+                break;
             }
-            const double stake = risk * balanceIt->second;
 
-            std::optional<Signal> sig = strategy_->onMarketDataUpdate(
-                updatedSymbols, orderBook_, stake, orderSizer_);
+            std::optional<Signal> sig = detectUpdates(updatedSymbols);
 
             if (sig.has_value()) [[unlikely]] {
-                executeArbitrage(*sig);
+                submitSignal(*sig);
             }
         } catch (const std::exception& e) {
             LOG_ERROR("[Runner] Error in main loop: {}", e.what());
@@ -418,9 +1102,144 @@ void Runner::run() {
         }
     }
 
+    stopExecutionThread();
     LOG_INFO("[Runner] Shutdown requested, exiting main loop");
 }
 
+void Runner::runEventQueue() {
+    LOG_INFO("[Runner] Starting event-queue loop...");
+
+    UpdateEvent event;
+    uint64_t expectedSeq = 0;
+    int idleSpins = 0;
+
+    while (!shutdownRequested_.load(std::memory_order_acquire)) {
+        try {
+            if (!eventRing_->tryPop(event)) {
+                if (++idleSpins < config_.busyPollSpinCount) {
+#ifdef __x86_64__
+                    _mm_pause();
+#endif
+                    continue;
+                }
+                // Park on the OrderBook wake path. The Feeder publishes to the
+                // ring before marking the book dirty, so a wake-up implies an event.
+                idleSpins = 0;
+                orderBook_.waitForUpdatesWithTimeout(std::chrono::milliseconds(100));
+                continue;
+            }
+            idleSpins = 0;
+
+            if (!hasTradableBalance()) [[unlikely]] {
+                LOG_CRITICAL("[Runner] No balance for any starting asset - exiting");
+                break;
+            }
+
+            const bool adopted = pendingGeneration_.load(std::memory_order_relaxed) != nullptr
+                && adoptPendingGeneration();
+
+            std::optional<Signal> sig;
+            if (event.seq != expectedSeq) [[unlikely]] {
+                // Ring overflowed: intermediate quotes are lost, re-screen everything
+                LOG_WARNING("[Runner] Event ring overflow: {} event(s) dropped, full re-screen",
+                            event.seq - expectedSeq);
+                sig = detectUpdates(subscribedMask_);
+            } else if (adopted) [[unlikely]] {
+                // New instances have no cached prices yet
+                sig = detectUpdates(subscribedMask_);
+            } else {
+                sig = detectSymbol(event.symbolId);
+            }
+            expectedSeq = event.seq + 1;
+
+            if (sig.has_value()) [[unlikely]] {
+                LOG_INFO("[Runner] Signal on {} event seq={}, tick-to-signal={} ticks",
+                         SymbolRegistry::instance().getSymbol(event.symbolId), event.seq,
+                         readTsc() - event.recvTsc);
+                submitSignal(*sig);
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("[Runner] Error in main loop: {}", e.what());
+            break;
+        }
+    }
+
+    LOG_INFO("[Runner] Shutdown requested, exiting event-queue loop");
+}
+
+void Runner::runReplay() {
+    LOG_INFO("[Runner] Starting replay loop...");
+
+    UpdateMask updatedSymbols;
+    UpdateEvent event;
+    uint64_t expectedSeq = 0;
+    uint64_t signalCount = 0;
+
+    auto onSignal = [&](const Signal& signal) {
+        ++signalCount;
+        LOG_INFO("[Runner] Replay signal #{} at record {} (recvTime={}ns): {} pnl={:.8f}",
+                 signalCount, replayFeeder_->position(), replayFeeder_->currentTimeNs(),
+                 signal.description, signal.pnl);
+        submitSignal(signal);
+    };
+
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    while (!shutdownRequested_.load(std::memory_order_acquire) && replayFeeder_->next()) {
+        try {
+            if (!hasTradableBalance()) [[unlikely]] {
+                LOG_CRITICAL("[Runner] No balance for any starting asset - stopping replay");
+                break;
+            }
+
+            if (eventRing_) {
+                // Same dispatch as runEventQueue, drained after every message
+                while (eventRing_->tryPop(event)) {
+                    std::optional<Signal> sig;
+                    if (event.seq != expectedSeq) [[unlikely]] {
+                        sig = detectUpdates(subscribedMask_);
+                    } else {
+                        sig = detectSymbol(event.symbolId);
+                    }
+                    expectedSeq = event.seq + 1;
+
+                    if (sig.has_value()) [[unlikely]] {
+                        onSignal(*sig);
+                    }
+                }
+                orderBook_.drainUpdates(updatedSymbols);
+                continue;
+            }
+
+            if (!orderBook_.drainUpdates(updatedSymbols)) {
+                continue;
+            }
+
+            std::optional<Signal> sig = detectUpdates(updatedSymbols);
+
+            if (sig.has_value()) [[unlikely]] {
+                onSignal(*sig);
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("[Runner] Error in replay loop: {}", e.what());
+            break;
+        }
+    }
+
+    const double elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    const uint64_t ticks = replayFeeder_->position();
+
+    LOG_INFO("[Runner] ========== REPLAY SUMMARY ==========");
+    LOG_INFO("[Runner] Records replayed: {} / {}", ticks, replayFeeder_->recordCount());
+    LOG_INFO("[Runner] Elapsed:          {:.3f}s", elapsedSec);
+    LOG_INFO("[Runner] Throughput:       {:.0f} ticks/s", elapsedSec > 0 ? ticks / elapsedSec : 0.0);
+    LOG_INFO("[Runner] Signals:          {}", signalCount);
+    for (const auto& strategy : strategies_) {
+        LOG_INFO("[Runner] {} Balance:      {:.8f}", strategy->startingAsset(), balance_[strategy->startingAsset()]);
+    }
+    LOG_INFO("[Runner] ====================================");
+}
+
 RunnerConfig Runner::loadConfig(const std::string& configFile) {
     RunnerConfig config;
     boost::property_tree::ptree pt;
@@ -428,19 +1247,56 @@ RunnerConfig Runner::loadConfig(const std::string& configFile) {
     try {
         boost::property_tree::ini_parser::read_ini(configFile, pt);
 
-        // Strategy config
-        config.strategyConfig.startingAsset = pt.get<std::string>("TRIANGULAR_ARB_STRATEGY.startingAsset");
-        config.strategyConfig.defaultFee = pt.get<double>("TRIANGULAR_ARB_STRATEGY.defaultFee", 0.1);
-        config.strategyConfig.risk = pt.get<double>("TRIANGULAR_ARB_STRATEGY.risk", 1.0);
-        config.strategyConfig.minProfitRatio = pt.get<double>("TRIANGULAR_ARB_STRATEGY.minProfitRatio", 1.0001);
+        // Strategy config (shared by every starting asset)
+        TriangularArbitrageConfig strategyConfig;
+        const std::string startingAssets = pt.get<std::string>("TRIANGULAR_ARB_STRATEGY.startingAsset");
+        strategyConfig.defaultFee = pt.get<double>("TRIANGULAR_ARB_STRATEGY.defaultFee", 0.1);
+        strategyConfig.risk = pt.get<double>("TRIANGULAR_ARB_STRATEGY.risk", 1.0);
+        strategyConfig.minProfitRatio = pt.get<double>("TRIANGULAR_ARB_STRATEGY.minProfitRatio", 1.0001);
+
+        std::string detectionModeStr = pt.get<std::string>("TRIANGULAR_ARB_STRATEGY.detectionMode", "rescreen");
+        if (detectionModeStr == "break_even") {
+            strategyConfig.detectionMode = DetectionMode::BreakEven;
+        } else if (detectionModeStr == "log_score") {
+            strategyConfig.detectionMode = DetectionMode::LogScore;
+        } else {
+            strategyConfig.detectionMode = DetectionMode::Rescreen;
+        }
+        strategyConfig.maxLegs = pt.get<int>("TRIANGULAR_ARB_STRATEGY.maxLegs", 3);
+        strategyConfig.logPaths = pt.get<bool>("TRIANGULAR_ARB_STRATEGY.logPaths", false);
+
+        // Stake ladder: comma-separated fractions of risk * balance
+        std::stringstream ladderStream(pt.get<std::string>("TRIANGULAR_ARB_STRATEGY.stakeLadder", ""));
+        std::string rung;
+        while (std::getline(ladderStream, rung, ',')) {
+            rung.erase(0, rung.find_first_not_of(" \t"));
+            rung.erase(rung.find_last_not_of(" \t") + 1);
+            if (rung.empty()) {
+                continue;
+            }
+            const double fraction = parseConfigDouble("TRIANGULAR_ARB_STRATEGY.stakeLadder", rung);
+            if (fraction <= 0.0 || fraction > 1.0) {
+                throw std::runtime_error("TRIANGULAR_ARB_STRATEGY.stakeLadder fractions must be in (0, 1]");
+            }
+            strategyConfig.stakeLadder.push_back(fraction);
+        }
+        std::sort(strategyConfig.stakeLadder.begin(), strategyConfig.stakeLadder.end());
 
         // Runner config
         config.liveMode = pt.get<bool>("TRIANGULAR_ARB_STRATEGY.liveMode", false);
+        const std::string executionModeStr = pt.get<std::string>("TRIANGULAR_ARB_STRATEGY.executionMode", "sequential");
+        config.executionMode = executionModeStr == "parallel" ? ExecutionMode::Parallel : ExecutionMode::Sequential;
+        config.rebalanceThreshold = pt.get<double>("TRIANGULAR_ARB_STRATEGY.rebalanceThreshold", 0.25);
+        if (config.rebalanceThreshold <= 0.0) {
+            throw std::runtime_error("TRIANGULAR_ARB_STRATEGY.rebalanceThreshold must be positive");
+        }
         config.fixMdEndpoint = pt.get<std::string>("FIX_CONNECTION.mdEndpoint", "fix-md.testnet.binance.vision");
         config.fixMdPort = pt.get<int>("FIX_CONNECTION.mdPort", 9000);
         config.fixOeEndpoint = pt.get<std::string>("FIX_CONNECTION.oeEndpoint", "fix-oe.testnet.binance.vision");
         config.fixOePort = pt.get<int>("FIX_CONNECTION.oePort", 9000);
+        config.marketDepth = std::clamp(pt.get<int>("FIX_CONNECTION.marketDepth", 1), 1, MAX_DEPTH_LEVELS);
         config.restEndpoint = pt.get<std::string>("FIX_CONNECTION.restEndpoint", "testnet.binance.vision");
+        config.exchangeInfoRefreshSec = std::max(0, pt.get<int>("FIX_CONNECTION.exchangeInfoRefreshSec", 0));
         config.apiKey = pt.get<std::string>("FIX_CONNECTION.apiKey");
         config.ed25519KeyPath = pt.get<std::string>("FIX_CONNECTION.ed25519KeyPath");
 
@@ -450,22 +1306,75 @@ RunnerConfig Runner::loadConfig(const std::string& configFile) {
             config.pollingMode = PollingMode::Blocking;
         } else if (pollingModeStr == "busy_poll") {
             config.pollingMode = PollingMode::BusyPoll;
+        } else if (pollingModeStr == "event_queue") {
+            config.pollingMode = PollingMode::EventQueue;
         } else {
             config.pollingMode = PollingMode::Hybrid;
         }
         config.busyPollSpinCount = pt.get<int>("PERFORMANCE.busyPollSpinCount", 10000);
+        config.eventRingCapacity = pt.get<size_t>("PERFORMANCE.eventRingCapacity", 65536);
+        config.maxConcurrentArbitrages = pt.get<size_t>("PERFORMANCE.maxConcurrentArbitrages", 4);
+        if (config.maxConcurrentArbitrages == 0) {
+            throw std::runtime_error("PERFORMANCE.maxConcurrentArbitrages must be at least 1");
+        }
 
         // Persistence config
         config.tradeLogDir = pt.get<std::string>("PERSISTENCE.tradeLogDir", "./trades");
+        config.routeCacheFile = pt.get<std::string>("PERSISTENCE.routeCacheFile", "");
+
+        // Replay config
+        config.replayJournal = pt.get<std::string>("REPLAY.journal", "");
+        std::string speedStr = pt.get<std::string>("REPLAY.speed", "max");
+        if (speedStr == "max") {
+            config.replaySpeed = 0.0;
+        } else if (speedStr == "realtime") {
+            config.replaySpeed = 1.0;
+        } else {
+            config.replaySpeed = parseConfigDouble("REPLAY.speed", speedStr);
+            if (config.replaySpeed <= 0.0) {
+                throw std::runtime_error("REPLAY.speed must be 'max', 'realtime' or a positive multiplier");
+            }
+        }
+        config.replayBalance = pt.get<double>("REPLAY.balance", 1000.0);
+        config.replayExchangeInfoFile = pt.get<std::string>("REPLAY.exchangeInfoFile", "");
+
+        auto replayBalancesSection = pt.get_child_optional("REPLAY_BALANCES");
+        if (replayBalancesSection) {
+            for (const auto& item : *replayBalancesSection) {
+                config.replayBalances[item.first] = item.second.get_value<double>();
+            }
+        }
 
         // Per-symbol fees
         auto symbolFeesSection = pt.get_child_optional("SYMBOL_FEES");
         if (symbolFeesSection) {
             for (const auto& item : *symbolFeesSection) {
-                config.strategyConfig.symbolFees[item.first] = item.second.get_value<double>();
+                strategyConfig.symbolFees[item.first] = item.second.get_value<double>();
             }
         }
 
+        // One instance per comma-separated starting asset, optional risk override
+        auto assetRiskSection = pt.get_child_optional("ASSET_RISK");
+        std::stringstream assetStream(startingAssets);
+        std::string asset;
+        while (std::getline(assetStream, asset, ',')) {
+            asset.erase(0, asset.find_first_not_of(" \t"));
+            asset.erase(asset.find_last_not_of(" \t") + 1);
+            if (asset.empty()) {
+                continue;
+            }
+
+            TriangularArbitrageConfig instanceConfig = strategyConfig;
+            instanceConfig.startingAsset = asset;
+            if (assetRiskSection) {
+                instanceConfig.risk = assetRiskSection->get<double>(asset, strategyConfig.risk);
+            }
+            config.strategyConfigs.push_back(std::move(instanceConfig));
+        }
+        if (config.strategyConfigs.empty()) {
+            throw std::runtime_error("TRIANGULAR_ARB_STRATEGY.startingAsset is empty");
+        }
+
     } catch (const boost::property_tree::ini_parser_error& e) {
         throw std::runtime_error("Failed to load config file: " + std::string(e.what()));
     } catch (const boost::property_tree::ptree_bad_path& e) {
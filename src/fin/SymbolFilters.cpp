@@ -1,5 +1,6 @@
 #include "fin/SymbolFilters.h"
 #include <cmath>
+#include <cstdlib>
 
 namespace {
     int computePrecision(double stepOrTick) {
@@ -22,6 +23,41 @@ namespace {
         return defaultVal;
     }
 
+    // Decimal string to fixed-point units, digit by digit: "0.00010000" is
+    // exactly 10000. Digits past the 8th decimal are dropped.
+    int64_t parseUnits(const std::string& text) {
+        int64_t whole = 0;
+        int64_t fraction = 0;
+        int64_t scale = Filters::FIXED_SCALE;
+        size_t i = 0;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+            whole = whole * 10 + (text[i] - '0');
+        }
+        if (i < text.size() && text[i] == '.') {
+            for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+                if (scale > 1) {
+                    scale /= 10;
+                    fraction += (text[i] - '0') * scale;
+                }
+            }
+        }
+        if (i != text.size()) {
+            // Exponent or sign: not the exchange's format, go through double
+            return std::llround(std::stod(text) * Filters::FIXED_SCALE_D);
+        }
+        return whole * Filters::FIXED_SCALE + fraction;
+    }
+
+    int64_t safeUnits(const nlohmann::json& j, const std::string& key) {
+        if (!j.contains(key)) return 0;
+        if (j[key].is_string()) {
+            return parseUnits(j[key].get<std::string>());
+        } else if (j[key].is_number()) {
+            return std::llround(j[key].get<double>() * Filters::FIXED_SCALE_D);
+        }
+        return 0;
+    }
+
     int safeStoi(const nlohmann::json& j, const std::string& key, int defaultVal = 0) {
         if (!j.contains(key)) return defaultVal;
         if (j[key].is_number()) {
@@ -60,18 +96,27 @@ SymbolFilters SymbolFilters::fromJson(const nlohmann::json& filtersJson) {
             filters.priceFilter_.maxPrice = safeStod(filter, "maxPrice");
             filters.priceFilter_.tickSize = safeStod(filter, "tickSize");
             filters.priceFilter_.precision = computePrecision(filters.priceFilter_.tickSize);
+            filters.priceFilter_.minPriceUnits = safeUnits(filter, "minPrice");
+            filters.priceFilter_.maxPriceUnits = safeUnits(filter, "maxPrice");
+            filters.priceFilter_.tickUnits = safeUnits(filter, "tickSize");
         }
         else if (filterType == "LOT_SIZE") {
             filters.lotSize_.minQty = safeStod(filter, "minQty");
             filters.lotSize_.maxQty = safeStod(filter, "maxQty");
             filters.lotSize_.stepSize = safeStod(filter, "stepSize");
             filters.lotSize_.precision = computePrecision(filters.lotSize_.stepSize);
+            filters.lotSize_.minUnits = safeUnits(filter, "minQty");
+            filters.lotSize_.maxUnits = safeUnits(filter, "maxQty");
+            filters.lotSize_.stepUnits = safeUnits(filter, "stepSize");
         }
         else if (filterType == "MARKET_LOT_SIZE") {
             filters.marketLotSize_.minQty = safeStod(filter, "minQty");
             filters.marketLotSize_.maxQty = safeStod(filter, "maxQty");
             filters.marketLotSize_.stepSize = safeStod(filter, "stepSize");
             filters.marketLotSize_.precision = computePrecision(filters.marketLotSize_.stepSize);
+            filters.marketLotSize_.minUnits = safeUnits(filter, "minQty");
+            filters.marketLotSize_.maxUnits = safeUnits(filter, "maxQty");
+            filters.marketLotSize_.stepUnits = safeUnits(filter, "stepSize");
         }
         else if (filterType == "MIN_NOTIONAL") {
             filters.minNotional_.minNotional = safeStod(filter, "minNotional");
@@ -3,6 +3,8 @@
 #include "rest/requests/endpoints/Account.hpp"
 #include "logger.hpp"
 
+#include <fstream>
+
 Admin::Admin(const std::string& endpoint, const std::string& apiKey, crypto::ed25519& key)
     : restClient_(std::make_unique<BNB::REST::ApiClient>(endpoint, apiKey, key))
 {
@@ -10,13 +12,40 @@ Admin::Admin(const std::string& endpoint, const std::string& apiKey, crypto::ed2
 }
 
 std::vector<fin::Symbol> Admin::fetchExchangeInfo() {
+    auto result = parseExchangeInfo(fetchExchangeInfoJson());
+
+    LOG_INFO("[Admin] Fetched {} symbols from exchange info", result.size());
+    return result;
+}
+
+nlohmann::json Admin::fetchExchangeInfoJson() {
     LOG_INFO("[Admin] Fetching exchange info from REST API...");
 
-    nlohmann::json response = restClient_->sendRequest(
+    return restClient_->sendRequest(
         BNB::REST::Endpoints::General::ExchangeInfo()
             .permissions({"SPOT"})
     );
+}
 
+nlohmann::json Admin::readExchangeInfoFile(const std::string& path) {
+    LOG_INFO("[Admin] Loading exchange info from file: {}", path);
+
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open exchange info file: " + path);
+    }
+
+    return nlohmann::json::parse(file);
+}
+
+std::vector<fin::Symbol> Admin::loadExchangeInfoFile(const std::string& path) {
+    auto result = parseExchangeInfo(readExchangeInfoFile(path));
+
+    LOG_INFO("[Admin] Loaded {} symbols from exchange info file", result.size());
+    return result;
+}
+
+std::vector<fin::Symbol> Admin::parseExchangeInfo(const nlohmann::json& response) {
     if (!response.contains("symbols")) {
         throw std::runtime_error("Exchange info response missing 'symbols' field");
     }
@@ -45,7 +74,6 @@ std::vector<fin::Symbol> Admin::fetchExchangeInfo() {
         );
     }
 
-    LOG_INFO("[Admin] Fetched {} symbols from exchange info", result.size());
     return result;
 }
 
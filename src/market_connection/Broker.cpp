@@ -2,99 +2,203 @@
 #include "fix/messages/NewSingleOrder.hpp"
 #include "fix/parsers/ExecutionReportParser.hpp"
 #include "codegen/fix/OE/FixValues.h"
+#include "fin/SymbolFilters.h"
 #include "logger.hpp"
 #include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    // Unique across restarts: clOrdIds are "TA<start ms>_<seq>"
+    std::string clOrdIdPrefix() {
+        auto now = std::chrono::system_clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+        return "TA" + std::to_string(ms) + "_";
+    }
+
+    constexpr int WAIT_SPINS = 1000;
+    constexpr auto WAIT_SLEEP = std::chrono::microseconds(100);
+
+    constexpr int CL_ORD_ID_TAG = 11;
+    constexpr int ORDER_QTY_TAG = 38;
+
+    size_t templateIndex(SymbolId symbolId, char side) {
+        return symbolId * 2 + (side == FIX::OE::Side_SELL ? 1 : 0);
+    }
+}
+
+struct Broker::OrderTemplate {
+    OrderTemplate(char side, const std::string& symbol)
+        : message(std::string(), FIX::OE::OrdType_MARKET, side, symbol)
+    {
+    }
+
+    std::atomic_flag inUse;
+    NewSingleOrder message;
+};
 
 Broker::Broker(const std::string& apiKey, crypto::ed25519& key, bool liveMode)
     : BNB::FIX::Broker(apiKey, key)
+    , orderSlots_(clOrdIdPrefix())
+    , templates_(std::make_unique<std::atomic<OrderTemplate*>[]>(MAX_SYMBOLS * 2))
     , liveMode_(liveMode)
 {
 }
 
+Broker::~Broker() = default;
+
+void Broker::prepareOrderTemplates(const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(templateMtx_);
+    size_t built = 0;
+    for (const auto& symbol : symbols) {
+        const SymbolId symbolId = SymbolRegistry::instance().getId(symbol);
+        if (symbolId == INVALID_SYMBOL_ID) {
+            continue;
+        }
+        for (char side : {FIX::OE::Side_BUY, FIX::OE::Side_SELL}) {
+            auto& entry = templates_[templateIndex(symbolId, side)];
+            if (entry.load(std::memory_order_relaxed) != nullptr) {
+                continue;
+            }
+            templateStore_.push_back(std::make_unique<OrderTemplate>(side, symbol));
+            entry.store(templateStore_.back().get(), std::memory_order_release);
+            ++built;
+        }
+    }
+    LOG_INFO("[Broker] Prepared {} order template(s) ({} in total)", built, templateStore_.size());
+}
+
 std::string Broker::sendMarketOrder(const std::string& symbol, char side, double qty, double estPrice) {
     std::string clOrdId = generateClOrdId();
+    sendMarketOrder(clOrdId, SymbolRegistry::instance().getId(symbol), symbol, side, qty, estPrice);
+    return clOrdId;
+}
 
+void Broker::sendMarketOrder(const std::string& clOrdId, SymbolId symbolId, const std::string& symbol, char side,
+                             double qty, double estPrice) {
     LOG_INFO("[Broker] Sending market order: clOrdId={}, symbol={}, side={}, qty={:.8f}",
              clOrdId, symbol, side, qty);
 
     if (!liveMode_) {
         LOG_WARNING("[Broker] Test mode - order not sent to exchange");
-        return testMarketOrder(symbol, side, qty, estPrice);
+        fillTestOrder(clOrdId, symbol, side, qty, estPrice);
+        return;
     }
 
     // Create order state before sending
-    {
-        std::lock_guard<std::mutex> lock(orderMtx_);
-        OrderState state;
-        state.clOrdId = clOrdId;
-        state.symbol = symbol;
-        state.side = side;
-        state.orderQty = qty;
-        state.status = OrderStatus::PENDING_NEW;
-        orderStates_[clOrdId] = state;
+    const uint64_t seq = orderSlots_.parseSeq(clOrdId);
+    if (seq == 0) {
+        throw std::runtime_error("Broker: clOrdId " + clOrdId + " was not issued by newClOrdId()");
+    }
+    if (!orderSlots_.claim(seq, symbol, side, qty, OrderStatus::PENDING_NEW)) {
+        LOG_WARNING("[Broker] Order slot reused while its previous order was still open ({})", clOrdId);
+    }
+
+    // Exact step multiple, no double formatting
+    char qtyText[Filters::UNITS_TEXT_SIZE];
+    const std::string orderQty(qtyText, Filters::formatUnits(Filters::toUnits(qty), qtyText));
+
+    OrderTemplate* prepared = symbolId < MAX_SYMBOLS
+        ? templates_[templateIndex(symbolId, side)].load(std::memory_order_acquire)
+        : nullptr;
+    if (prepared != nullptr && !prepared->inUse.test_and_set(std::memory_order_acquire)) [[likely]] {
+        // The session still stamps MsgSeqNum and SendingTime and serializes
+        prepared->message.setField(CL_ORD_ID_TAG, clOrdId);
+        prepared->message.setField(ORDER_QTY_TAG, orderQty);
+        sendMessage(prepared->message);
+        prepared->inUse.clear(std::memory_order_release);
+        return;
     }
 
     NewSingleOrder order(clOrdId, FIX::OE::OrdType_MARKET, side, symbol);
-    order.orderQty(qty);
+    order.setField(ORDER_QTY_TAG, orderQty);
 
     sendMessage(order);
-
-    return clOrdId;
 }
 
 std::string Broker::testMarketOrder(const std::string& symbol, char side, double qty, double estPrice) {
     std::string clOrdId = generateClOrdId();
+    fillTestOrder(clOrdId, symbol, side, qty, estPrice);
+    return clOrdId;
+}
 
+void Broker::fillTestOrder(const std::string& clOrdId, const std::string& symbol, char side, double qty,
+                           double estPrice) {
     LOG_INFO("[Broker] Test market order: clOrdId={}, symbol={}, side={}, qty={}, estPrice={}",
              clOrdId, symbol, side, qty, estPrice);
 
+    const uint64_t seq = orderSlots_.parseSeq(clOrdId);
+    if (seq == 0) {
+        throw std::runtime_error("Broker: clOrdId " + clOrdId + " was not issued by newClOrdId()");
+    }
+
     // Simulate immediate fill in test mode using estimated price
-    {
-        std::lock_guard<std::mutex> lock(orderMtx_);
-        OrderState state;
-        state.clOrdId = clOrdId;
-        state.symbol = symbol;
-        state.side = side;
-        state.orderQty = qty;
-        state.cumQty = qty;
-        state.avgPx = estPrice;  // Use estimated price for test mode
-        state.status = OrderStatus::FILLED;
-        orderStates_[clOrdId] = state;
-    }
-    orderCv_.notify_all();
+    orderSlots_.claim(seq, symbol, side, qty, OrderStatus::PENDING_NEW);
+    OrderSlot* slot = orderSlots_.find(seq);
+    slot->cumQty.store(qty, std::memory_order_relaxed);
+    slot->cumCost.store(qty * estPrice, std::memory_order_relaxed);
+    slot->avgPx.store(estPrice, std::memory_order_relaxed);  // Use estimated price for test mode
+    slot->status.store(OrderStatus::FILLED, std::memory_order_release);
 
-    return clOrdId;
+    notifyDone(snapshot(*slot, clOrdId));
+}
+
+void Broker::notifyDone(const OrderState& state) {
+    if (auto* listener = listener_.load(std::memory_order_acquire)) {
+        listener->onOrderDone(state);
+    }
+}
+
+OrderState Broker::snapshot(const OrderSlot& slot, const std::string& clOrdId) const {
+    OrderState state;
+    state.clOrdId = clOrdId;
+    state.status = slot.status.load(std::memory_order_acquire);
+    state.symbol = slot.symbol;
+    state.side = slot.side;
+    state.orderQty = slot.orderQty.load(std::memory_order_relaxed);
+    state.cumQty = slot.cumQty.load(std::memory_order_relaxed);
+    state.cumCost = slot.cumCost.load(std::memory_order_relaxed);
+    state.avgPx = slot.avgPx.load(std::memory_order_relaxed);
+    if (OrderSlot::isFinal(state.status)) {
+        // Texts are written before the final status and never again
+        state.orderId = slot.orderId;
+        state.rejectReason = slot.rejectReason;
+    }
+    return state;
 }
 
 OrderState Broker::getOrderState(const std::string& clOrdId) {
-    std::lock_guard<std::mutex> lock(orderMtx_);
-    auto it = orderStates_.find(clOrdId);
-    if (it != orderStates_.end()) {
-        return it->second;
+    if (const OrderSlot* slot = orderSlots_.find(orderSlots_.parseSeq(clOrdId))) {
+        return snapshot(*slot, clOrdId);
     }
     return OrderState{};
 }
 
 OrderStatus Broker::waitForOrderCompletion(const std::string& clOrdId, int timeoutMs) {
-    std::unique_lock<std::mutex> lock(orderMtx_);
+    const uint64_t seq = orderSlots_.parseSeq(clOrdId);
     auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
 
-    while (true) {
-        auto it = orderStates_.find(clOrdId);
-        if (it != orderStates_.end()) {
-            OrderStatus status = it->second.status;
-            if (status == OrderStatus::FILLED ||
-                status == OrderStatus::CANCELED ||
-                status == OrderStatus::REJECTED ||
-                status == OrderStatus::EXPIRED) {
-                return status;
-            }
+    for (int spins = 0; ; ++spins) {
+        const OrderSlot* slot = orderSlots_.find(seq);
+        if (slot == nullptr) {
+            LOG_WARNING("[Broker] Unknown order or slot already reused: {}", clOrdId);
+            return OrderStatus::UNKNOWN;
         }
 
-        if (orderCv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+        OrderStatus status = slot->status.load(std::memory_order_acquire);
+        if (OrderSlot::isFinal(status)) {
+            return status;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) {
             LOG_WARNING("[Broker] Timeout waiting for order completion: {}", clOrdId);
             return OrderStatus::UNKNOWN;
         }
+        if (spins < WAIT_SPINS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(WAIT_SLEEP);
+        }
     }
 }
 
@@ -106,36 +210,41 @@ void Broker::onMessage(const FIX44::OE::ExecutionReport& message, const FIX::Ses
              exec.clOrdId, exec.symbol, static_cast<int>(exec.execType), static_cast<int>(exec.status),
              exec.cumQty, exec.lastPx, exec.lastQty);
 
-    {
-        std::lock_guard<std::mutex> lock(orderMtx_);
-        auto it = orderStates_.find(exec.clOrdId);
-        if (it == orderStates_.end()) {
-            // New order we haven't seen before
-            OrderState state;
-            state.clOrdId = exec.clOrdId;
-            orderStates_[exec.clOrdId] = state;
-            it = orderStates_.find(exec.clOrdId);
-        }
+    OrderSlot* slot = orderSlots_.find(orderSlots_.parseSeq(exec.clOrdId));
+    if (slot == nullptr) {
+        LOG_WARNING("[Broker] ExecutionReport for an unknown or expired order: {}", exec.clOrdId);
+        return;
+    }
+    if (OrderSlot::isFinal(slot->status.load(std::memory_order_relaxed))) {
+        LOG_WARNING("[Broker] ExecutionReport after the final one, ignored: {}", exec.clOrdId);
+        return;
+    }
 
-        it->second.orderId = exec.orderId;
-        it->second.symbol = exec.symbol;
-        it->second.side = BNB::FIX::sideToChar(exec.side);
-        it->second.orderQty = exec.orderQty;
-        it->second.cumQty = exec.cumQty;
-        it->second.status = exec.status;
-        it->second.rejectReason = exec.text;
-
-        // Calculate avgPx from fills (for TRADE exec type)
-        if (exec.execType == BNB::FIX::ExecType::TRADE && exec.lastQty > 0) {
-            it->second.cumCost += exec.lastPx * exec.lastQty;
-            if (it->second.cumQty > 0) {
-                it->second.avgPx = it->second.cumCost / it->second.cumQty;
-            }
-            LOG_INFO("[Broker] Fill: lastPx={:.8f}, lastQty={:.8f}, avgPx={:.8f}",
-                     exec.lastPx, exec.lastQty, it->second.avgPx);
+    // Only this thread writes a sent order's slot; the status goes last
+    slot->orderQty.store(exec.orderQty, std::memory_order_relaxed);
+    slot->cumQty.store(exec.cumQty, std::memory_order_relaxed);
+
+    // Calculate avgPx from fills (for TRADE exec type)
+    if (exec.execType == BNB::FIX::ExecType::TRADE && exec.lastQty > 0) {
+        const double cumCost = slot->cumCost.load(std::memory_order_relaxed) + exec.lastPx * exec.lastQty;
+        slot->cumCost.store(cumCost, std::memory_order_relaxed);
+        if (exec.cumQty > 0) {
+            slot->avgPx.store(cumCost / exec.cumQty, std::memory_order_relaxed);
         }
+        LOG_INFO("[Broker] Fill: lastPx={:.8f}, lastQty={:.8f}, avgPx={:.8f}",
+                 exec.lastPx, exec.lastQty, slot->avgPx.load(std::memory_order_relaxed));
+    }
+
+    const bool done = OrderSlot::isFinal(exec.status);
+    if (done) {
+        OrderSlot::copyText(slot->orderId, exec.orderId);
+        OrderSlot::copyText(slot->rejectReason, exec.text);
+    }
+    slot->status.store(exec.status, std::memory_order_release);
+
+    if (done) {
+        notifyDone(snapshot(*slot, exec.clOrdId));
     }
-    orderCv_.notify_all();
 }
 
 void Broker::onMessage(const FIX44::OE::OrderCancelReject& message, const FIX::SessionID& sessionID) {
@@ -154,7 +263,5 @@ void Broker::onMessage(const FIX44::OE::OrderCancelReject& message, const FIX::S
 }
 
 std::string Broker::generateClOrdId() {
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-    return "TA" + std::to_string(ms) + "_" + std::to_string(++orderIdCounter_);
+    return orderSlots_.clOrdId(orderSlots_.nextSeq());
 }
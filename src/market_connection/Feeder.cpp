@@ -3,8 +3,72 @@
 #include "fix/messages/MarketDataRequest.hpp"
 #include "fix/parsers/InstrumentListParser.hpp"
 #include "fix/parsers/MarketDataParser.hpp"
+#include "codegen/fix/MD/FixValues.h"
+#include "common/Tsc.h"
 #include "logger.hpp"
 
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+namespace {
+    // MDReqID prefixes: BookTicker request N and its paired depth-stream request N
+    constexpr const char* TOP_REQ_PREFIX = "mdReq";
+    constexpr const char* DEPTH_REQ_PREFIX = "mdDepth";
+
+    constexpr int SENDING_TIME_TAG = 52;
+
+    uint64_t wallClockNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * Parse FIX UTCTimestamp "YYYYMMDD-HH:MM:SS[.fff...]" into ns since epoch.
+     * Returns 0 if the field is malformed.
+     */
+    uint64_t parseUtcTimestampNs(const std::string& value) {
+        if (value.size() < 17 || value[8] != '-') {
+            return 0;
+        }
+
+        auto digits = [&value](size_t pos, size_t len) {
+            int result = 0;
+            for (size_t i = pos; i < pos + len; ++i) {
+                result = result * 10 + (value[i] - '0');
+            }
+            return result;
+        };
+
+        std::tm tm{};
+        tm.tm_year = digits(0, 4) - 1900;
+        tm.tm_mon = digits(4, 2) - 1;
+        tm.tm_mday = digits(6, 2);
+        tm.tm_hour = digits(9, 2);
+        tm.tm_min = digits(12, 2);
+        tm.tm_sec = digits(15, 2);
+
+        uint64_t fractionNs = 0;
+        if (value.size() > 18 && value[17] == '.') {
+            uint64_t scale = 100000000;
+            for (size_t i = 18; i < value.size() && scale > 0; ++i, scale /= 10) {
+                fractionNs += static_cast<uint64_t>(value[i] - '0') * scale;
+            }
+        }
+
+        const time_t seconds = timegm(&tm);
+        return static_cast<uint64_t>(seconds) * 1'000'000'000ULL + fractionNs;
+    }
+
+    uint64_t sendingTimeNs(const FIX::Message& message) {
+        const auto& header = message.getHeader();
+        if (!header.isSetField(SENDING_TIME_TAG)) {
+            return 0;
+        }
+        return parseUtcTimestampNs(header.getField(SENDING_TIME_TAG));
+    }
+}
+
 Feeder::Feeder(const std::string& apiKey, crypto::ed25519& key, OrderBook& orderBook)
     : BNB::FIX::Feeder(apiKey, key)
     , orderBook_(orderBook)
@@ -33,6 +97,34 @@ SymbolId Feeder::getOrCreateSymbolId(const std::string& symbol) {
     return id;
 }
 
+void Feeder::applyQuote(SymbolId symbolId, double bid, double ask,
+                        double bidQty, double askQty, uint64_t recvTsc) {
+    if (!eventRing_) [[likely]] {
+        orderBook_.update(symbolId, bid, ask, bidQty, askQty);
+        return;
+    }
+
+    // Publish the event before signalling so a woken consumer always finds it
+    if (orderBook_.storeQuote(symbolId, bid, ask, bidQty, askQty)) {
+        eventRing_->publish(symbolId, bid, ask, recvTsc);
+        orderBook_.markUpdated(symbolId);
+    }
+}
+
+void Feeder::recordQuote(JournalRecordType type, SymbolId symbolId, const std::string& symbol,
+                         const BNB::FIX::MarketDataUpdate& update, uint64_t recvTimeNs, uint64_t exchTimeNs) {
+    JournalRecord record{};
+    record.recvTimeNs = recvTimeNs;
+    record.exchTimeNs = exchTimeNs;
+    record.bid = update.bestBidPrice;
+    record.ask = update.bestAskPrice;
+    record.bidQty = update.bestBidQty;
+    record.askQty = update.bestAskQty;
+    record.symbolId = journal_->journalId(symbolId, symbol);
+    record.type = type;
+    journal_->append(record);
+}
+
 void Feeder::subscribeToSymbols(const std::vector<std::string>& symbols) {
     if (symbols.empty()) {
         LOG_WARNING("[Feeder] No symbols to subscribe to");
@@ -47,7 +139,7 @@ void Feeder::subscribeToSymbols(const std::vector<std::string>& symbols) {
     }
 
     setExpectedSymbols(symbols);
-    std::string reqId = "mdReq" + std::to_string(++mdReqIdCounter_);
+    std::string reqId = TOP_REQ_PREFIX + std::to_string(++mdReqIdCounter_);
 
     {
         std::lock_guard<std::mutex> lock(subscriptionMtx_);
@@ -63,6 +155,104 @@ void Feeder::subscribeToSymbols(const std::vector<std::string>& symbols) {
     }
 
     sendMessage(request);
+
+    if (depthBook_ && depthBook_->depth() > 1) {
+        std::string depthReqId = DEPTH_REQ_PREFIX + std::to_string(mdReqIdCounter_);
+        {
+            std::lock_guard<std::mutex> lock(subscriptionMtx_);
+            subscriptionSymbols_[depthReqId] = symbols;
+        }
+
+        LOG_INFO("[Feeder] Subscribing to depth-{} stream for {} symbols", depthBook_->depth(), symbols.size());
+
+        MarketDataRequest depthRequest(depthReqId, SubscriptionAction::Subscribe);
+        depthRequest.subscribeToStream(StreamType::DiffDepth);
+        depthRequest.setMarketDepth(depthBook_->depth());
+
+        for (const auto& symbol : symbols) {
+            depthRequest.forSymbol(symbol);
+        }
+
+        sendMessage(depthRequest);
+    }
+}
+
+template <typename Message>
+bool Feeder::isDepthMessage(const Message& message) const {
+    if (!depthBook_) [[likely]] {
+        return false;
+    }
+
+    FIX::MD::MDReqID reqId;
+    if (!message.isSet(reqId)) {
+        return false;
+    }
+    message.get(reqId);
+
+    return reqId.getValue().rfind(DEPTH_REQ_PREFIX, 0) == 0;
+}
+
+template <typename Message>
+void Feeder::applyDepthEntries(const Message& message, bool isSnapshot) {
+    FIX::MD::NoMDEntries noEntries;
+    message.get(noEntries);
+
+    SymbolId symbolId = INVALID_SYMBOL_ID;
+
+    // Snapshots carry the symbol once at message level and replace the book
+    if (isSnapshot) {
+        FIX::MD::Symbol symbolField;
+        message.get(symbolField);
+        symbolId = getOrCreateSymbolId(symbolField.getValue());
+        depthBook_->beginUpdate(symbolId);
+        depthBook_->clear(symbolId);
+    }
+
+    typename Message::NoMDEntries group;
+    for (int i = 1; i <= noEntries.getValue(); ++i) {
+        message.getGroup(i, group);
+
+        char action = FIX::MD::MDUpdateAction_NEW;
+        if (!isSnapshot) {
+            // Incremental refresh: symbol is only present on its first entry
+            FIX::MD::Symbol symbolField;
+            if (group.isSet(symbolField)) {
+                group.get(symbolField);
+                if (symbolId != INVALID_SYMBOL_ID) {
+                    depthBook_->endUpdate(symbolId);
+                }
+                symbolId = getOrCreateSymbolId(symbolField.getValue());
+                depthBook_->beginUpdate(symbolId);
+            }
+
+            FIX::MD::MDUpdateAction actionField;
+            group.get(actionField);
+            action = actionField.getValue();
+        }
+
+        if (symbolId == INVALID_SYMBOL_ID) [[unlikely]] {
+            continue;
+        }
+
+        FIX::MD::MDEntryType entryType;
+        FIX::MD::MDEntryPx px;
+        group.get(entryType);
+        group.get(px);
+
+        double qty = 0.0;
+        if (action != FIX::MD::MDUpdateAction_DELETE) {
+            FIX::MD::MDEntrySize size;
+            group.get(size);
+            qty = size.getValue();
+        }
+
+        const BookSide side = (entryType.getValue() == FIX::MD::MDEntryType_BID) ? BookSide::Bid : BookSide::Ask;
+        depthBook_->applyLevel(symbolId, side, px.getValue(), qty);
+    }
+
+    if (symbolId != INVALID_SYMBOL_ID) {
+        depthBook_->endUpdate(symbolId);
+    }
 }
 
 void Feeder::unsubscribeFromSymbols(const std::vector<std::string>& symbols) {
@@ -73,10 +263,15 @@ void Feeder::unsubscribeFromSymbols(const std::vector<std::string>& symbols) {
 
     LOG_INFO("[Feeder] Unsubscribing from {} symbols", symbols.size());
 
+    // The BookTicker request is looked up; its depth request goes with it
     std::string reqIdToUnsubscribe;
+    std::string depthReqId;
     {
         std::lock_guard<std::mutex> lock(subscriptionMtx_);
         for (const auto& [reqId, subSymbols] : subscriptionSymbols_) {
+            if (reqId.rfind(TOP_REQ_PREFIX, 0) != 0) {
+                continue;
+            }
             for (const auto& sym : symbols) {
                 if (std::find(subSymbols.begin(), subSymbols.end(), sym) != subSymbols.end()) {
                     reqIdToUnsubscribe = reqId;
@@ -85,6 +280,13 @@ void Feeder::unsubscribeFromSymbols(const std::vector<std::string>& symbols) {
             }
             if (!reqIdToUnsubscribe.empty()) break;
         }
+
+        if (!reqIdToUnsubscribe.empty()) {
+            const std::string paired = DEPTH_REQ_PREFIX + reqIdToUnsubscribe.substr(std::strlen(TOP_REQ_PREFIX));
+            if (subscriptionSymbols_.count(paired) != 0) {
+                depthReqId = paired;
+            }
+        }
     }
 
     if (reqIdToUnsubscribe.empty()) {
@@ -96,9 +298,18 @@ void Feeder::unsubscribeFromSymbols(const std::vector<std::string>& symbols) {
     request.setMarketDepth(1);
     sendMessage(request);
 
+    if (!depthReqId.empty()) {
+        MarketDataRequest depthRequest(depthReqId, SubscriptionAction::Unsubscribe);
+        depthRequest.setMarketDepth(depthBook_ ? depthBook_->depth() : 1);
+        sendMessage(depthRequest);
+    }
+
     {
         std::lock_guard<std::mutex> lock(subscriptionMtx_);
         subscriptionSymbols_.erase(reqIdToUnsubscribe);
+        if (!depthReqId.empty()) {
+            subscriptionSymbols_.erase(depthReqId);
+        }
     }
 }
 
@@ -131,16 +342,31 @@ void Feeder::onMessage(const FIX44::MD::InstrumentList& message, const FIX::Sess
 }
 
 void Feeder::onMessage(const FIX44::MD::MarketDataSnapshot& message, const FIX::SessionID& sessionID) {
+    const uint64_t recvTsc = readTsc();
+
+    // Depth stream feeds the DepthBook only; top of book comes from BookTicker
+    if (isDepthMessage(message)) {
+        applyDepthEntries(message, true);
+        return;
+    }
+
     auto update = BNB::FIX::MarketDataParser::parseSnapshot(message);
 
-    LOG_DEBUG("[Feeder] Received snapshot for {}: bid={}, ask={}",
-              update.symbol, update.bestBidPrice, update.bestAskPrice);
+    LOG_DEBUG("[Feeder] Received snapshot for {}: bid={}x{}, ask={}x{}",
+              update.symbol, update.bestBidPrice, update.bestBidQty,
+              update.bestAskPrice, update.bestAskQty);
 
     // Get symbol ID (should be cached from subscription)
     SymbolId symbolId = getOrCreateSymbolId(update.symbol);
 
     // Update lock-free order book using SymbolId
-    orderBook_.update(symbolId, update.bestBidPrice, update.bestAskPrice);
+    applyQuote(symbolId, update.bestBidPrice, update.bestAskPrice,
+               update.bestBidQty, update.bestAskQty, recvTsc);
+
+    if (journal_) {
+        recordQuote(JournalRecordType::Snapshot, symbolId, update.symbol, update,
+                    wallClockNs(), sendingTimeNs(message));
+    }
 
     // Track snapshot receipt
     bool allReceived = false;
@@ -157,17 +383,38 @@ void Feeder::onMessage(const FIX44::MD::MarketDataSnapshot& message, const FIX::
 }
 
 void Feeder::onMessage(const FIX44::MD::MarketDataIncrementalRefresh& message, const FIX::SessionID& sessionID) {
+    const uint64_t recvTsc = readTsc();
+
+    if (isDepthMessage(message)) {
+        applyDepthEntries(message, false);
+        return;
+    }
+
     auto updates = BNB::FIX::MarketDataParser::parseIncrementalRefresh(message);
 
+    uint64_t recvTimeNs = 0;
+    uint64_t exchTimeNs = 0;
+    if (journal_) {
+        recvTimeNs = wallClockNs();
+        exchTimeNs = sendingTimeNs(message);
+    }
+
     for (const auto& update : updates) {
-        LOG_DEBUG("[Feeder] Received update for {}: bid={}, ask={}",
-                  update.symbol, update.bestBidPrice, update.bestAskPrice);
+        LOG_DEBUG("[Feeder] Received update for {}: bid={}x{}, ask={}x{}",
+                  update.symbol, update.bestBidPrice, update.bestBidQty,
+                  update.bestAskPrice, update.bestAskQty);
 
         // Get symbol ID (should be cached)
         SymbolId symbolId = getOrCreateSymbolId(update.symbol);
 
         // Update lock-free order book using SymbolId
-        orderBook_.update(symbolId, update.bestBidPrice, update.bestAskPrice);
+        applyQuote(symbolId, update.bestBidPrice, update.bestAskPrice,
+                   update.bestBidQty, update.bestAskQty, recvTsc);
+
+        if (journal_) {
+            recordQuote(JournalRecordType::Incremental, symbolId, update.symbol, update,
+                        recvTimeNs, exchTimeNs);
+        }
     }
 }
 
@@ -0,0 +1,157 @@
+#include "market_connection/LegPipeline.h"
+#include "logger.hpp"
+
+#include <algorithm>
+
+LegPipeline::LegPipeline(Broker& broker)
+    : broker_(broker)
+{
+}
+
+bool LegPipeline::start(std::vector<PlannedLeg> legs, bool parallel, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (state_.load(std::memory_order_relaxed) != State::Idle || legs.empty()) {
+        return false;
+    }
+
+    result_ = PipelineResult{};
+    result_.legs = std::move(legs);
+    result_.fills.assign(result_.legs.size(), LegFill{});
+    parallel_ = parallel;
+    timeoutMs_ = timeoutMs;
+    pendingClOrdIds_.assign(result_.legs.size(), std::string());
+    pending_ = 0;
+    state_.store(State::Running, std::memory_order_release);
+
+    // Every clOrdId is recorded before the first send
+    const size_t count = parallel ? result_.legs.size() : 1;
+    std::vector<std::pair<std::string, PlannedLeg>> sends;
+    sends.reserve(count);
+    for (size_t leg = 0; leg < count; ++leg) {
+        sends.emplace_back(armLeg(leg), result_.legs[leg]);
+    }
+    lock.unlock();
+
+    for (const auto& [clOrdId, leg] : sends) {
+        broker_.sendMarketOrder(clOrdId, leg.symbolId, leg.symbol, leg.side, leg.qty, leg.estPrice);
+    }
+    return true;
+}
+
+std::string LegPipeline::armLeg(size_t leg) {
+    pendingClOrdIds_[leg] = broker_.newClOrdId();
+    result_.fills[leg].clOrdId = pendingClOrdIds_[leg];
+    result_.fills[leg].sentQty = result_.legs[leg].qty;
+    ++pending_;
+    deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs_);
+    return pendingClOrdIds_[leg];
+}
+
+void LegPipeline::recordFailure(size_t leg, const std::string& clOrdId, const std::string& reason) {
+    if (result_.failed) {
+        LOG_ERROR("[LegPipeline] Leg {} also failed: {}", leg + 1, reason);
+        return;
+    }
+    result_.failed = true;
+    result_.failedLeg = static_cast<int>(leg);
+    result_.failedClOrdId = clOrdId;
+    result_.reason = reason;
+}
+
+void LegPipeline::finish() {
+    std::fill(pendingClOrdIds_.begin(), pendingClOrdIds_.end(), std::string());
+    pending_ = 0;
+    state_.store(State::Done, std::memory_order_release);
+}
+
+void LegPipeline::onOrderDone(const OrderState& state) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (state_.load(std::memory_order_relaxed) != State::Running) {
+        return;
+    }
+
+    size_t index = 0;
+    while (index < pendingClOrdIds_.size() && pendingClOrdIds_[index] != state.clOrdId) {
+        ++index;
+    }
+    if (state.clOrdId.empty() || index == pendingClOrdIds_.size()) {
+        return;  // Rollback order, or a report that arrived after its leg timed out
+    }
+    pendingClOrdIds_[index].clear();
+    --pending_;
+
+    const PlannedLeg& leg = result_.legs[index];
+    const std::string legName = std::to_string(index + 1);
+
+    // Partial fills are still recorded so that they get rolled back
+    result_.fills[index].filledQty = state.cumQty;
+    result_.fills[index].avgPrice = state.avgPx;
+
+    if (state.status != OrderStatus::FILLED) {
+        recordFailure(index, state.clOrdId, state.status == OrderStatus::REJECTED
+            ? "Order rejected at leg " + legName + ": " + state.rejectReason
+            : "Order failed at leg " + legName + " with status " + std::to_string(static_cast<int>(state.status)));
+    } else if (state.cumQty < leg.qty * 0.99) {
+        recordFailure(index, state.clOrdId, "Partial fill at leg " + legName + ": requested " +
+                      std::to_string(leg.qty) + ", filled " + std::to_string(state.cumQty));
+    }
+
+    if (parallel_) {
+        if (pending_ == 0) {
+            finish();
+        }
+        return;
+    }
+
+    const size_t nextIndex = index + 1;
+    if (result_.failed || nextIndex == result_.legs.size()) {
+        finish();
+        return;
+    }
+
+    // What the fill actually delivered, after fee, in the next leg's input asset
+    const double received = (leg.way == Way::BUY ? state.cumQty : state.cumQty * state.avgPx)
+                          * (1.0 - leg.feeRate);
+
+    PlannedLeg& next = result_.legs[nextIndex];
+    // Floored, never lifted to minQty: that would spend more than the fill delivered
+    next.qty = next.filters.floorMarketQty(next.way == Way::BUY ? received / next.estPrice : received);
+    if (next.qty <= 0 || next.qty < next.filters.minMarketQty()) {
+        recordFailure(nextIndex, std::string(),
+                      "Leg " + std::to_string(nextIndex + 1) + " falls below the minimum quantity after the fill of leg " +
+                      legName + ": " + std::to_string(next.qty));
+        finish();
+        return;
+    }
+
+    const std::string clOrdId = armLeg(nextIndex);
+    const PlannedLeg send = next;
+    lock.unlock();
+
+    broker_.sendMarketOrder(clOrdId, send.symbolId, send.symbol, send.side, send.qty, send.estPrice);
+}
+
+std::optional<PipelineResult> LegPipeline::collect() {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    if (state_.load(std::memory_order_relaxed) == State::Running &&
+        std::chrono::steady_clock::now() > deadline_) {
+        for (size_t leg = 0; leg < pendingClOrdIds_.size(); ++leg) {
+            if (!pendingClOrdIds_[leg].empty()) {
+                LOG_WARNING("[LegPipeline] Timeout waiting for order completion: {}", pendingClOrdIds_[leg]);
+                recordFailure(leg, pendingClOrdIds_[leg], "Order timeout at leg " + std::to_string(leg + 1) +
+                              " - manual intervention required");
+            }
+        }
+        finish();
+    }
+
+    if (state_.load(std::memory_order_relaxed) != State::Done) {
+        return std::nullopt;
+    }
+
+    std::optional<PipelineResult> done(std::move(result_));
+    result_ = PipelineResult{};
+    state_.store(State::Idle, std::memory_order_release);
+    return done;
+}
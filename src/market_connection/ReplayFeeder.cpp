@@ -0,0 +1,98 @@
+#include "market_connection/ReplayFeeder.h"
+#include "common/Tsc.h"
+#include "logger.hpp"
+
+#include <thread>
+
+ReplayFeeder::ReplayFeeder(const std::string& journalPath, OrderBook& orderBook, double speed)
+    : journal_(journalPath)
+    , orderBook_(orderBook)
+    , speed_(speed)
+{
+    idMap_.fill(INVALID_SYMBOL_ID);
+
+    size_t mapped = 0;
+    for (uint32_t id = 0; id < journal_.symbolCount(); ++id) {
+        std::string symbol = journal_.symbol(static_cast<SymbolId>(id));
+        if (!symbol.empty()) {
+            idMap_[id] = SymbolRegistry::instance().registerSymbol(symbol);
+            ++mapped;
+        }
+    }
+
+    if (journal_.recordCount() > 0) {
+        firstTimeNs_ = journal_.record(0).recvTimeNs;
+    }
+
+    LOG_INFO("[ReplayFeeder] Journal {} ({}): {} records, {} symbols, speed={}",
+             journalPath, journal_.date(), journal_.recordCount(), mapped,
+             speed_ > 0.0 ? std::to_string(speed_) + "x" : std::string("max"));
+}
+
+std::vector<std::string> ReplayFeeder::symbols() const {
+    std::vector<std::string> result;
+    for (uint32_t id = 0; id < journal_.symbolCount(); ++id) {
+        std::string symbol = journal_.symbol(static_cast<SymbolId>(id));
+        if (!symbol.empty()) {
+            result.push_back(std::move(symbol));
+        }
+    }
+    return result;
+}
+
+bool ReplayFeeder::next() {
+    const uint64_t count = journal_.recordCount();
+    if (position_ >= count) {
+        return false;
+    }
+
+    const uint64_t recvTimeNs = journal_.record(position_).recvTimeNs;
+    if (speed_ > 0.0) {
+        pace(recvTimeNs);
+    }
+    currentTimeNs_ = recvTimeNs;
+
+    // An incremental refresh carrying several symbols was recorded with one timestamp
+    do {
+        applyRecord(journal_.record(position_));
+        ++position_;
+    } while (position_ < count && journal_.record(position_).recvTimeNs == recvTimeNs);
+
+    return true;
+}
+
+void ReplayFeeder::pace(uint64_t recvTimeNs) {
+    if (position_ == 0) {
+        wallStart_ = std::chrono::steady_clock::now();
+        return;
+    }
+
+    // Wall clock may step backwards in a capture; never schedule before the start
+    const uint64_t offsetNs = recvTimeNs > firstTimeNs_ ? recvTimeNs - firstTimeNs_ : 0;
+    const double elapsedNs = static_cast<double>(offsetNs) / speed_;
+    const auto target = wallStart_ + std::chrono::nanoseconds(static_cast<int64_t>(elapsedNs));
+    if (target > std::chrono::steady_clock::now()) {
+        std::this_thread::sleep_until(target);
+    }
+}
+
+void ReplayFeeder::applyRecord(const JournalRecord& record) {
+    if (record.symbolId >= MAX_SYMBOLS) [[unlikely]] {
+        return;
+    }
+    const SymbolId symbolId = idMap_[record.symbolId];
+    if (symbolId == INVALID_SYMBOL_ID) [[unlikely]] {
+        return;
+    }
+
+    // Same write sequence as Feeder::applyQuote
+    if (!eventRing_) [[likely]] {
+        orderBook_.update(symbolId, record.bid, record.ask, record.bidQty, record.askQty);
+        return;
+    }
+
+    if (orderBook_.storeQuote(symbolId, record.bid, record.ask, record.bidQty, record.askQty)) {
+        eventRing_->publish(symbolId, record.bid, record.ask, readTsc());
+        orderBook_.markUpdated(symbolId);
+    }
+}
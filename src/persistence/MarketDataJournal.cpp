@@ -0,0 +1,268 @@
+#include "persistence/MarketDataJournal.h"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr size_t PAGE_SIZE_BYTES = 4096;
+
+    std::string errnoString() {
+        return std::strerror(errno);
+    }
+}
+
+uint64_t MarketDataJournal::dataOffset() noexcept {
+    // Records start on a page boundary after the header + dictionary
+    return (sizeof(JournalHeader) + PAGE_SIZE_BYTES - 1) / PAGE_SIZE_BYTES * PAGE_SIZE_BYTES;
+}
+
+std::string MarketDataJournal::filename(const std::string& date) {
+    return "md_" + date + ".bin";
+}
+
+MarketDataJournal::MarketDataJournal(const std::string& outputDir, const std::string& date,
+                                     size_t chunkRecords)
+    : chunkBytes_(chunkRecords * sizeof(JournalRecord))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(outputDir, ec);
+    if (ec) {
+        throw std::runtime_error("MarketDataJournal: cannot create " + outputDir + ": " + ec.message());
+    }
+
+    path_ = outputDir + "/" + filename(date);
+
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("MarketDataJournal: cannot open " + path_ + ": " + errnoString());
+    }
+
+    journalIds_.fill(INVALID_SYMBOL_ID);
+
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0) {
+        const std::string error = errnoString();
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error("MarketDataJournal: fstat failed on " + path_ + ": " + error);
+    }
+
+    try {
+        openMapping(date, static_cast<size_t>(st.st_size));
+    } catch (...) {
+        // Leave the file as found: no mapping, no descriptor, original size
+        if (base_) {
+            ::munmap(base_, mappedBytes_);
+            base_ = nullptr;
+        }
+        if (::ftruncate(fd_, st.st_size) != 0) {
+            LOG_ERROR("[MarketDataJournal] Failed to restore the size of {}: {}", path_, errnoString());
+        }
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+}
+
+void MarketDataJournal::openMapping(const std::string& date, size_t fileBytes) {
+    const bool resume = fileBytes >= dataOffset();
+    const size_t existingBytes = resume ? fileBytes : 0;
+    const size_t initialBytes = std::max(existingBytes, static_cast<size_t>(dataOffset())) + chunkBytes_;
+
+    if (::ftruncate(fd_, static_cast<off_t>(initialBytes)) != 0) {
+        throw std::runtime_error("MarketDataJournal: ftruncate failed on " + path_ + ": " + errnoString());
+    }
+
+    void* mapped = ::mmap(nullptr, initialBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("MarketDataJournal: mmap failed on " + path_ + ": " + errnoString());
+    }
+    base_ = static_cast<char*>(mapped);
+    mappedBytes_ = initialBytes;
+    capacityRecords_ = (mappedBytes_ - dataOffset()) / sizeof(JournalRecord);
+
+    auto* hdr = header();
+    if (resume) {
+        if (hdr->magic != JOURNAL_MAGIC || hdr->version != JOURNAL_VERSION ||
+            hdr->recordSize != sizeof(JournalRecord)) {
+            throw std::runtime_error("MarketDataJournal: incompatible existing journal " + path_);
+        }
+        recordCount_ = hdr->recordCount;
+        // The dictionary is kept, ids are matched by name on first use (see journalId)
+        LOG_INFO("[MarketDataJournal] Resuming {} at record {}", path_, recordCount_);
+    } else {
+        std::memset(hdr, 0, sizeof(JournalHeader));
+        hdr->magic = JOURNAL_MAGIC;
+        hdr->version = JOURNAL_VERSION;
+        hdr->recordSize = sizeof(JournalRecord);
+        hdr->dataOffset = dataOffset();
+        hdr->maxSymbols = MAX_SYMBOLS;
+        std::strncpy(hdr->date, date.c_str(), sizeof(hdr->date) - 1);
+        LOG_INFO("[MarketDataJournal] Created {}", path_);
+    }
+}
+
+MarketDataJournal::~MarketDataJournal() {
+    close();
+}
+
+SymbolId MarketDataJournal::defineSymbol(SymbolId id, const std::string& symbol) {
+    auto* hdr = header();
+    char name[JOURNAL_SYMBOL_NAME_LEN] = {};
+    std::strncpy(name, symbol.c_str(), JOURNAL_SYMBOL_NAME_LEN - 1);
+    auto holds = [&](size_t slot) {
+        return std::strncmp(hdr->symbols[slot], name, JOURNAL_SYMBOL_NAME_LEN) == 0;
+    };
+
+    // Same id as this process when the file agrees or the id is free there
+    size_t slot = MAX_SYMBOLS;
+    if (holds(id)) {
+        slot = id;
+    }
+    for (size_t i = 0; slot == MAX_SYMBOLS && i < hdr->symbolCount; ++i) {
+        if (holds(i)) {
+            slot = i;
+        }
+    }
+    if (slot == MAX_SYMBOLS && hdr->symbols[id][0] == '\0') {
+        slot = id;
+    }
+    for (size_t i = 0; slot == MAX_SYMBOLS && i < MAX_SYMBOLS; ++i) {
+        if (hdr->symbols[i][0] == '\0') {
+            slot = i;
+        }
+    }
+    if (slot == MAX_SYMBOLS) {
+        throw std::runtime_error("MarketDataJournal: symbol dictionary of " + path_ + " is full");
+    }
+
+    if (hdr->symbols[slot][0] == '\0') {
+        std::memcpy(hdr->symbols[slot], name, JOURNAL_SYMBOL_NAME_LEN);
+        hdr->symbolCount = std::max<uint32_t>(hdr->symbolCount, static_cast<uint32_t>(slot) + 1);
+    }
+    if (slot != id) {
+        LOG_INFO("[MarketDataJournal] {} (SymbolId {}) recorded under journal id {}", symbol, id, slot);
+    }
+
+    journalIds_[id] = static_cast<SymbolId>(slot);
+    return journalIds_[id];
+}
+
+void MarketDataJournal::append(const JournalRecord& record) {
+    if (recordCount_ == capacityRecords_) [[unlikely]] {
+        grow();
+    }
+
+    auto* records = reinterpret_cast<JournalRecord*>(base_ + dataOffset());
+    records[recordCount_] = record;
+    ++recordCount_;
+
+    std::atomic_ref<uint64_t>(header()->recordCount).store(recordCount_, std::memory_order_release);
+}
+
+void MarketDataJournal::grow() {
+    const size_t newBytes = mappedBytes_ + chunkBytes_;
+
+    if (::ftruncate(fd_, static_cast<off_t>(newBytes)) != 0) {
+        throw std::runtime_error("MarketDataJournal: ftruncate failed on " + path_ + ": " + errnoString());
+    }
+
+    void* mapped = ::mremap(base_, mappedBytes_, newBytes, MREMAP_MAYMOVE);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("MarketDataJournal: mremap failed on " + path_ + ": " + errnoString());
+    }
+
+    base_ = static_cast<char*>(mapped);
+    mappedBytes_ = newBytes;
+    capacityRecords_ = (mappedBytes_ - dataOffset()) / sizeof(JournalRecord);
+}
+
+void MarketDataJournal::close() {
+    if (fd_ < 0) {
+        return;
+    }
+
+    const size_t usedBytes = dataOffset() + recordCount_ * sizeof(JournalRecord);
+
+    if (base_) {
+        ::msync(base_, mappedBytes_, MS_SYNC);
+        ::munmap(base_, mappedBytes_);
+        base_ = nullptr;
+    }
+
+    if (::ftruncate(fd_, static_cast<off_t>(usedBytes)) != 0) {
+        LOG_ERROR("[MarketDataJournal] Failed to trim {}: {}", path_, errnoString());
+    }
+
+    ::close(fd_);
+    fd_ = -1;
+
+    LOG_INFO("[MarketDataJournal] Closed {} ({} records)", path_, recordCount_);
+}
+
+MarketDataJournalReader::MarketDataJournalReader(const std::string& path)
+    : path_(path)
+{
+    const int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MarketDataJournalReader: cannot open " + path_ + ": " + errnoString());
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MarketDataJournalReader: fstat failed on " + path_ + ": " + errnoString());
+    }
+
+    mappedBytes_ = static_cast<size_t>(st.st_size);
+    if (mappedBytes_ < sizeof(JournalHeader)) {
+        ::close(fd);
+        throw std::runtime_error("MarketDataJournalReader: " + path_ + " is too small to be a journal");
+    }
+
+    void* mapped = ::mmap(nullptr, mappedBytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("MarketDataJournalReader: mmap failed on " + path_ + ": " + errnoString());
+    }
+    base_ = static_cast<const char*>(mapped);
+    header_ = reinterpret_cast<const JournalHeader*>(base_);
+
+    if (header_->magic != JOURNAL_MAGIC || header_->version != JOURNAL_VERSION ||
+        header_->recordSize != sizeof(JournalRecord)) {
+        ::munmap(const_cast<char*>(base_), mappedBytes_);
+        throw std::runtime_error("MarketDataJournalReader: incompatible journal " + path_);
+    }
+
+    // Header count is authoritative; the file may still carry an unused tail
+    const uint64_t available = mappedBytes_ > header_->dataOffset
+        ? (mappedBytes_ - header_->dataOffset) / sizeof(JournalRecord) : 0;
+    recordCount_ = std::min(header_->recordCount, available);
+    records_ = reinterpret_cast<const JournalRecord*>(base_ + header_->dataOffset);
+
+    ::madvise(const_cast<char*>(base_), mappedBytes_, MADV_SEQUENTIAL);
+
+    LOG_INFO("[MarketDataJournalReader] Opened {} ({} records, {} symbols)",
+             path_, recordCount_, header_->symbolCount);
+}
+
+MarketDataJournalReader::~MarketDataJournalReader() {
+    if (base_) {
+        ::munmap(const_cast<char*>(base_), mappedBytes_);
+    }
+}
+
+std::string MarketDataJournalReader::symbol(SymbolId id) const {
+    const char* name = header_->symbols[id];
+    return std::string(name, strnlen(name, JOURNAL_SYMBOL_NAME_LEN));
+}
@@ -0,0 +1,263 @@
+#include "persistence/RouteCache.h"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    uint64_t fnv1a(uint64_t hash, const std::string& text) {
+        // Length first so that ("AB", "C") and ("A", "BC") differ
+        const uint64_t size = text.size();
+        hash = fnv1a(hash, &size, sizeof(size));
+        return fnv1a(hash, text.data(), text.size());
+    }
+
+    // Fixed-width field copy; false if the value does not fit
+    template <size_t N>
+    bool copyField(char (&dst)[N], const std::string& value) {
+        if (value.size() >= N) {
+            return false;
+        }
+        std::memset(dst, 0, N);
+        std::memcpy(dst, value.data(), value.size());
+        return true;
+    }
+
+    template <size_t N>
+    std::string readField(const char (&src)[N]) {
+        return std::string(src, strnlen(src, N));
+    }
+}
+
+RouteCache::RouteCache(std::string path)
+    : path_(std::move(path))
+{
+}
+
+uint64_t RouteCache::computeKey(
+    const nlohmann::json& exchangeInfo,
+    const std::vector<std::string>& startingAssets)
+{
+    uint64_t hash = FNV_OFFSET;
+    hash = fnv1a(hash, &ROUTE_CACHE_VERSION, sizeof(ROUTE_CACHE_VERSION));
+
+    // Only the symbol list: serverTime and rate limits change on every call
+    hash = fnv1a(hash, exchangeInfo.contains("symbols") ? exchangeInfo["symbols"].dump() : std::string());
+
+    for (const auto& asset : startingAssets) {
+        hash = fnv1a(hash, asset);
+    }
+    return hash;
+}
+
+bool RouteCache::load(
+    uint64_t key,
+    const std::vector<std::string>& startingAssets,
+    std::vector<fin::Symbol>& symbols,
+    std::vector<std::vector<RouteDescriptor>>& routes) const
+{
+    const int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_INFO("[RouteCache] No route cache at {}", path_);
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RouteCacheHeader)) {
+        ::close(fd);
+        LOG_WARNING("[RouteCache] Ignoring unreadable route cache {}", path_);
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_WARNING("[RouteCache] mmap failed on {}: {}", path_, std::strerror(errno));
+        return false;
+    }
+
+    const auto* base = static_cast<const char*>(mapped);
+    const auto* header = reinterpret_cast<const RouteCacheHeader*>(base);
+
+    const size_t expectedSize = sizeof(RouteCacheHeader)
+        + header->symbolCount * sizeof(RouteCacheSymbol)
+        + header->strategyCount * sizeof(RouteCacheStrategy)
+        + header->routeCount * sizeof(RouteDescriptor);
+
+    bool valid = header->magic == ROUTE_CACHE_MAGIC
+        && header->version == ROUTE_CACHE_VERSION
+        && header->filtersSize == sizeof(SymbolFilters)
+        && header->fileSize == fileSize
+        && expectedSize == fileSize;
+
+    if (valid && header->key != key) {
+        LOG_INFO("[RouteCache] Exchange info or starting assets changed, cache {} is stale", path_);
+        ::munmap(mapped, fileSize);
+        return false;
+    }
+
+    const auto* cachedSymbols = reinterpret_cast<const RouteCacheSymbol*>(base + sizeof(RouteCacheHeader));
+    const auto* cachedStrategies = reinterpret_cast<const RouteCacheStrategy*>(cachedSymbols + header->symbolCount);
+    const auto* cachedRoutes = reinterpret_cast<const RouteDescriptor*>(cachedStrategies + header->strategyCount);
+
+    valid = valid && header->strategyCount == startingAssets.size();
+    for (uint32_t s = 0; valid && s < header->strategyCount; ++s) {
+        const auto& strategy = cachedStrategies[s];
+        valid = readField(strategy.startingAsset) == startingAssets[s]
+            && strategy.firstRoute + strategy.routeCount <= header->routeCount;
+    }
+    for (uint64_t r = 0; valid && r < header->routeCount; ++r) {
+        valid = std::all_of(cachedRoutes[r].symbols.begin(), cachedRoutes[r].symbols.end(),
+                            [&](uint32_t idx) { return idx < header->symbolCount; });
+    }
+
+    if (!valid) {
+        LOG_WARNING("[RouteCache] Ignoring incompatible route cache {}", path_);
+        ::munmap(mapped, fileSize);
+        return false;
+    }
+
+    // Restore the registry first so ids match the run that wrote the cache
+    std::vector<const RouteCacheSymbol*> byId;
+    for (uint32_t i = 0; i < header->symbolCount; ++i) {
+        if (cachedSymbols[i].registryId != INVALID_SYMBOL_ID) {
+            byId.push_back(&cachedSymbols[i]);
+        }
+    }
+    std::sort(byId.begin(), byId.end(), [](const RouteCacheSymbol* a, const RouteCacheSymbol* b) {
+        return a->registryId < b->registryId;
+    });
+    auto& registry = SymbolRegistry::instance();
+    size_t remapped = 0;
+    for (const auto* cached : byId) {
+        if (registry.registerSymbol(readField(cached->symbol)) != cached->registryId) {
+            ++remapped;
+        }
+    }
+    if (remapped > 0) {
+        LOG_WARNING("[RouteCache] {} symbol(s) got a different SymbolId than in the cache", remapped);
+    }
+
+    symbols.clear();
+    symbols.reserve(header->symbolCount);
+    for (uint32_t i = 0; i < header->symbolCount; ++i) {
+        const auto& cached = cachedSymbols[i];
+        symbols.emplace_back(readField(cached.base), readField(cached.quote),
+                             readField(cached.symbol), cached.filters);
+    }
+
+    routes.assign(header->strategyCount, {});
+    for (uint32_t s = 0; s < header->strategyCount; ++s) {
+        const auto* first = cachedRoutes + cachedStrategies[s].firstRoute;
+        routes[s].assign(first, first + cachedStrategies[s].routeCount);
+    }
+
+    LOG_INFO("[RouteCache] Loaded {} symbols and {} routes for {} starting asset(s) from {}",
+             header->symbolCount, header->routeCount, header->strategyCount, path_);
+
+    ::munmap(mapped, fileSize);
+    return true;
+}
+
+void RouteCache::save(
+    uint64_t key,
+    const std::vector<std::string>& startingAssets,
+    const std::vector<fin::Symbol>& symbols,
+    const std::vector<std::vector<RouteDescriptor>>& routes) const
+{
+    RouteCacheHeader header{};
+    header.magic = ROUTE_CACHE_MAGIC;
+    header.version = ROUTE_CACHE_VERSION;
+    header.filtersSize = sizeof(SymbolFilters);
+    header.key = key;
+    header.symbolCount = static_cast<uint32_t>(symbols.size());
+    header.strategyCount = static_cast<uint32_t>(startingAssets.size());
+
+    const auto& registry = SymbolRegistry::instance();
+    // Value-initialised: names and reserved bytes start zeroed
+    std::vector<RouteCacheSymbol> cachedSymbols(symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        auto& cached = cachedSymbols[i];
+        if (!copyField(cached.symbol, symbols[i].to_str()) ||
+            !copyField(cached.base, symbols[i].getBase()) ||
+            !copyField(cached.quote, symbols[i].getQuote())) {
+            LOG_WARNING("[RouteCache] Name too long for the cache ({}), not saving", symbols[i].to_str());
+            return;
+        }
+        cached.registryId = registry.getId(symbols[i].to_str());
+        cached.filters = symbols[i].getFilters();
+    }
+
+    std::vector<RouteCacheStrategy> cachedStrategies(startingAssets.size());
+    for (size_t s = 0; s < startingAssets.size(); ++s) {
+        auto& cached = cachedStrategies[s];
+        if (!copyField(cached.startingAsset, startingAssets[s])) {
+            LOG_WARNING("[RouteCache] Asset name too long for the cache ({}), not saving", startingAssets[s]);
+            return;
+        }
+        cached.firstRoute = header.routeCount;
+        cached.routeCount = routes[s].size();
+        header.routeCount += routes[s].size();
+    }
+
+    header.fileSize = sizeof(RouteCacheHeader)
+        + cachedSymbols.size() * sizeof(RouteCacheSymbol)
+        + cachedStrategies.size() * sizeof(RouteCacheStrategy)
+        + header.routeCount * sizeof(RouteDescriptor);
+
+    const std::filesystem::path target(path_);
+    std::error_code ec;
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+    }
+
+    const std::string tmpPath = path_ + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(cachedSymbols.data()),
+                  static_cast<std::streamsize>(cachedSymbols.size() * sizeof(RouteCacheSymbol)));
+        out.write(reinterpret_cast<const char*>(cachedStrategies.data()),
+                  static_cast<std::streamsize>(cachedStrategies.size() * sizeof(RouteCacheStrategy)));
+        for (const auto& strategyRoutes : routes) {
+            out.write(reinterpret_cast<const char*>(strategyRoutes.data()),
+                      static_cast<std::streamsize>(strategyRoutes.size() * sizeof(RouteDescriptor)));
+        }
+        if (!out) {
+            LOG_WARNING("[RouteCache] Failed to write {}", tmpPath);
+            std::filesystem::remove(tmpPath, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, target, ec);
+    if (ec) {
+        LOG_WARNING("[RouteCache] Failed to replace {}: {}", path_, ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return;
+    }
+
+    LOG_INFO("[RouteCache] Saved {} symbols and {} routes to {} ({} bytes)",
+             header.symbolCount, header.routeCount, path_, header.fileSize);
+}
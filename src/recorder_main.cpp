@@ -0,0 +1,164 @@
+#include "market_connection/Admin.h"
+#include "market_connection/Feeder.h"
+#include "market_connection/OrderBook.h"
+#include "persistence/MarketDataJournal.h"
+#include "common/Scheduler.h"
+#include "crypto/utils.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <getopt.h>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+
+namespace {
+    // Symbols per MarketDataRequest when subscribing to the whole exchange
+    constexpr size_t SUBSCRIPTION_CHUNK_SIZE = 200;
+
+    std::atomic<bool> stopRequested{false};
+
+    void onSignal(int) {
+        stopRequested.store(true, std::memory_order_relaxed);
+    }
+
+    std::vector<std::string> splitSymbols(const std::string& list) {
+        std::vector<std::string> symbols;
+        std::stringstream ss(list);
+        std::string symbol;
+        while (std::getline(ss, symbol, ',')) {
+            if (!symbol.empty()) {
+                symbols.push_back(symbol);
+            }
+        }
+        return symbols;
+    }
+}
+
+void printUsage(const std::string& programName) {
+    std::cout << "Usage: " << programName << " --symbol <all|SYM1,SYM2> --date <YYYY-MM-DD> --configfile <path_to_ini>" << std::endl;
+    std::cout << "       --symbol, -s     : 'all' or a comma-separated symbol list." << std::endl;
+    std::cout << "       --date, -d       : Trading day to record (UTC)." << std::endl;
+    std::cout << "       --configfile, -c : Path to the configuration INI file." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string symbolArg;
+    std::string date;
+    std::string configFile;
+
+    static struct option long_options[] = {
+        {"symbol", required_argument, 0, 's'},
+        {"date", required_argument, 0, 'd'},
+        {"configfile", required_argument, 0, 'c'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int option_index = 0;
+    int c;
+    while ((c = getopt_long(argc, argv, "s:d:c:h", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 's':
+                symbolArg = optarg;
+                break;
+            case 'd':
+                date = optarg;
+                break;
+            case 'c':
+                configFile = optarg;
+                break;
+            case 'h':
+                printUsage(argv[0]);
+                return 0;
+            case '?':
+            default:
+                printUsage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (symbolArg.empty() || date.empty() || configFile.empty()) {
+        std::cerr << "Error: --symbol, --date and --configfile parameters are required." << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        boost::property_tree::ptree pt;
+        boost::property_tree::ini_parser::read_ini(configFile, pt);
+
+        const auto apiKey = pt.get<std::string>("FIX_CONNECTION.apiKey");
+        const auto keyPath = pt.get<std::string>("FIX_CONNECTION.ed25519KeyPath");
+        const auto restEndpoint = pt.get<std::string>("FIX_CONNECTION.restEndpoint", "testnet.binance.vision");
+        const auto outputDir = pt.get<std::string>("RECORDER.outputDir", "./data");
+
+        Scheduler scheduler(date);
+        if (!scheduler.waitStart()) {
+            return 1;
+        }
+
+        crypto::ed25519 key(readPemFile(keyPath));
+
+        std::vector<std::string> symbols;
+        if (symbolArg == "all") {
+            Admin admin(restEndpoint, apiKey, key);
+            for (const auto& symbol : admin.fetchExchangeInfo()) {
+                symbols.push_back(symbol.to_str());
+            }
+        } else {
+            symbols = splitSymbols(symbolArg);
+        }
+
+        if (symbols.empty()) {
+            std::cerr << "Error: no symbols to record." << std::endl;
+            return 1;
+        }
+
+        // Journal file is keyed by YYYYMMDD
+        std::string journalDate = date;
+        journalDate.erase(std::remove(journalDate.begin(), journalDate.end(), '-'), journalDate.end());
+        MarketDataJournal journal(outputDir, journalDate);
+
+        // OrderBook is ~256KB of slots, keep it off the stack
+        auto orderBook = std::make_unique<OrderBook>();
+        Feeder feeder(apiKey, key, *orderBook);
+        feeder.setJournal(&journal);
+
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        LOG_INFO("[Recorder] Connecting FIX market data session...");
+        feeder.connect();
+        feeder.waitUntilConnected();
+
+        LOG_INFO("[Recorder] Recording {} symbols to {}", symbols.size(), journal.path());
+        for (size_t i = 0; i < symbols.size(); i += SUBSCRIPTION_CHUNK_SIZE) {
+            const auto end = std::min(i + SUBSCRIPTION_CHUNK_SIZE, symbols.size());
+            feeder.subscribeToSymbols(std::vector<std::string>(symbols.begin() + i, symbols.begin() + end));
+        }
+
+        const auto stopTime = scheduler.getStopTime();
+        while (!stopRequested.load(std::memory_order_relaxed) &&
+               std::chrono::system_clock::now() < stopTime) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+
+        LOG_INFO("[Recorder] Stopping...");
+        feeder.disconnect();
+        journal.close();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,215 +1,424 @@
 #include "strategies/circular_arbitrage/ArbitragePath.h"
 #include "logger.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <limits>
 #include <sstream>
 
-ArbitragePath::ArbitragePath(
-    std::vector<Order> orders,
-    const FeeFunction& getFee)
-    : orders_(std::move(orders))
-{
+// ArbitragePathPool implementation
+
+size_t ArbitragePathPool::addPath(std::vector<Order> orders, const FeeFunction& getFee) {
     auto& registry = SymbolRegistry::instance();
 
-    for (size_t leg = 0; leg < 3 && leg < orders_.size(); ++leg) {
-        const auto& order = orders_[leg];
+    PathRecord record;
+    record.feeProduct = 1.0;
+
+    for (size_t leg = 0; leg < 3 && leg < orders.size(); ++leg) {
+        const auto& order = orders[leg];
         const std::string& symbolStr = order.getSymbol().to_str();
 
         // Register symbol and store ID
-        symbolIds_[leg] = registry.registerSymbol(symbolStr);
-        symbolStrings_[leg] = symbolStr;
+        record.ids[leg] = registry.registerSymbol(symbolStr);
 
-        // Store leg direction
-        isBuy_[leg] = (order.getWay() == Way::BUY);
+        if (order.getWay() == Way::BUY) {
+            record.buyMask |= static_cast<uint8_t>(1u << leg);
+        }
 
         // Pre-compute fee multiplier: (1 - fee/100)
-        double feePct = getFee(symbolStr);
-        feeMultipliers_[leg] = 1.0 - feePct / 100.0;
+        record.feeMultipliers[leg] = 1.0 - getFee(symbolStr) / 100.0;
+        record.feeProduct *= record.feeMultipliers[leg];
     }
 
-    buildDescription();
-}
+    record.kernel = kernelFor(record.buyMask);
 
-void ArbitragePath::buildDescription() {
+    std::array<LegLot, 3> lots;
+    for (size_t leg = 0; leg < 3 && leg < orders.size(); ++leg) {
+        lots[leg] = LegLot::fromFilters(orders[leg].getSymbol().getFilters());
+    }
+
+    PathColdData cold;
     std::ostringstream oss;
-    for (size_t i = 0; i < orders_.size(); ++i) {
+    for (size_t i = 0; i < orders.size(); ++i) {
         if (i > 0) oss << " ";
-        oss << orders_[i].to_str();
+        oss << orders[i].to_str();
     }
-    cachedDescription_ = oss.str();
+    cold.description = oss.str();
+    cold.orders = std::move(orders);
+
+    const size_t index = records_.size();
+    records_.push_back(record);
+    lots_.push_back(lots);
+    cold_.push_back(std::move(cold));
+    return index;
 }
 
-void ArbitragePath::updatePrices(const OrderBook& orderBook) {
-    BidAsk p0, p1, p2;
+double ArbitragePathPool::refresh(uint32_t index, const OrderBook& orderBook, PathQuotes& quotes) noexcept {
+    PathRecord& record = records_[index];
+    BidAsk p[3];
 
     // Batch read with prefetch optimization
-    orderBook.getTriple(symbolIds_[0], symbolIds_[1], symbolIds_[2], p0, p1, p2);
+    orderBook.getTriple(record.ids[0], record.ids[1], record.ids[2], p[0], p[1], p[2]);
+
+    double ratio = record.feeProduct;
+    for (size_t leg = 0; leg < 3; ++leg) {
+        quotes.bids[leg] = p[leg].bid;
+        quotes.asks[leg] = p[leg].ask;
+        quotes.bidQtys[leg] = p[leg].bidQty;
+        quotes.askQtys[leg] = p[leg].askQty;
 
-    bids_[0] = p0.bid;
-    bids_[1] = p1.bid;
-    bids_[2] = p2.bid;
-    asks_[0] = p0.ask;
-    asks_[1] = p1.ask;
-    asks_[2] = p2.ask;
+        if (record.isBuy(leg)) {
+            quotes.rates[leg] = p[leg].ask > 0 ? 1.0 / p[leg].ask : 0.0;
+        } else {
+            quotes.rates[leg] = p[leg].bid > 0 ? p[leg].bid : 0.0;
+        }
+        ratio *= quotes.rates[leg];
+    }
 
-    // Compute effective multipliers for ratio calculation
-    pricesValid_ = true;
+    record.ratio = ratio;
+    return ratio;
+}
+
+double ArbitragePathPool::maxExecutableStake(uint32_t index, const PathQuotes& quotes) const noexcept {
+    const PathRecord& record = records_[index];
+    double cap = std::numeric_limits<double>::infinity();
+
+    // Units of the current leg's input asset per unit of starting asset
+    double rate = 1.0;
 
     for (size_t leg = 0; leg < 3; ++leg) {
-        if (isBuy_[leg]) {
-            if (asks_[leg] > 0) [[likely]] {
-                effectiveMultipliers_[leg] = 1.0 / asks_[leg];
-            } else {
-                effectiveMultipliers_[leg] = 0.0;
-                pricesValid_ = false;
-            }
-        } else {
-            if (bids_[leg] > 0) [[likely]] {
-                effectiveMultipliers_[leg] = bids_[leg];
+        // Capacity of the best level, expressed in this leg's input asset:
+        // BUY spends quote (askQty * ask), SELL gives base (bidQty)
+        const bool isBuy = record.isBuy(leg);
+        const double levelQty = isBuy ? quotes.askQtys[leg] : quotes.bidQtys[leg];
+        if (levelQty > 0 && rate > 0) {
+            const double legCapacity = isBuy ? levelQty * quotes.asks[leg] : levelQty;
+            cap = std::min(cap, legCapacity / rate);
+        }
+        rate *= quotes.rates[leg] * record.feeMultipliers[leg];
+    }
+
+    return cap;
+}
+
+namespace {
+    using StakeLanes = std::array<double, ArbitragePathPool::MAX_STAKE_RUNGS>;
+
+    // One leg of a kernel for every ladder rung at once; IsBuy is a template
+    // argument, so the lane loop has no branch (the lot step is an integer
+    // remainder per lane)
+    template <bool IsBuy>
+    inline void kernelLeg(
+        const LegLot& lot,
+        double bid,
+        double ask,
+        double feeMultiplier,
+        StakeLanes& amount,
+        StakeLanes& qty,
+        StakeLanes& lotOk) noexcept
+    {
+        for (size_t r = 0; r < ArbitragePathPool::MAX_STAKE_RUNGS; ++r) {
+            if constexpr (IsBuy) {
+                // BUY: give quote, get base = amount / ask, fee on what we get
+                qty[r] = amount[r] / ask;
+                amount[r] = qty[r] * feeMultiplier;
+                lotOk[r] = lot.round(amount[r]) > 0 ? lotOk[r] : 0.0;
             } else {
-                effectiveMultipliers_[leg] = 0.0;
-                pricesValid_ = false;
+                // SELL: give the lot-rounded base, get quote = qty * bid, fee on it
+                qty[r] = lot.round(amount[r]);
+                lotOk[r] = qty[r] > 0 ? lotOk[r] : 0.0;
+                amount[r] = qty[r] * bid * feeMultiplier;
             }
         }
     }
 }
 
-double ArbitragePath::getFastRatio() const noexcept {
-    if (!pricesValid_) [[unlikely]] {
-        return 0.0;
+void ArbitragePathPool::setStakeLadder(const std::vector<double>& fractions) {
+    ladder_.fill(0.0);
+    ladderSize_ = std::min(fractions.size(), MAX_STAKE_RUNGS);
+    std::copy_n(fractions.begin(), ladderSize_, ladder_.begin());
+
+    if (ladderSize_ == 0) {
+        ladder_[0] = 1.0;
+        ladderSize_ = 1;
     }
+}
 
-    // Compute ratio: product of (effective_multiplier * fee_multiplier)
-    double ratio = 1.0;
-    ratio *= effectiveMultipliers_[0] * feeMultipliers_[0];
-    ratio *= effectiveMultipliers_[1] * feeMultipliers_[1];
-    ratio *= effectiveMultipliers_[2] * feeMultipliers_[2];
+LegLot LegLot::fromFilters(const SymbolFilters& filters) {
+    // Mirrors SymbolFilters::roundMarketQty -> MarketLotSizeFilter/LotSizeFilter::roundQty
+    const bool market = filters.marketLotSize().isValid();
+    const int64_t stepUnits = market ? filters.marketLotSize().stepUnits : filters.lotSize().stepUnits;
+    const int64_t minUnits = market ? filters.marketLotSize().minUnits : filters.lotSize().minUnits;
+    const int64_t maxUnits = market ? filters.marketLotSize().maxUnits : filters.lotSize().maxUnits;
+
+    LegLot lot;
+    lot.stepUnits = stepUnits > 0 ? stepUnits : 1;
+    lot.minUnits = minUnits > 0 ? minUnits : 0;
+    lot.maxUnits = maxUnits > 0 ? maxUnits : std::numeric_limits<int64_t>::max();
+    return lot;
+}
 
-    return ratio;
+template <uint8_t BuyMask>
+std::optional<Signal> ArbitragePathPool::evaluateKernel(
+    const ArbitragePathPool& pool,
+    uint32_t index,
+    const PathQuotes& quotes,
+    double initialStake)
+{
+    const PathRecord& record = pool.records_[index];
+    const auto& lots = pool.lots_[index];
+
+    const bool pricesValid = (quotes.bids[0] > 0) & (quotes.asks[0] > 0)
+                           & (quotes.bids[1] > 0) & (quotes.asks[1] > 0)
+                           & (quotes.bids[2] > 0) & (quotes.asks[2] > 0);
+
+    // Never size beyond what the best levels can absorb. Unused rungs
+    // (fraction 0) are masked out up front: a minQty could round them up.
+    const double cap = pool.maxExecutableStake(index, quotes);
+    StakeLanes stakes;
+    StakeLanes amount;
+    StakeLanes lotOk;
+    for (size_t r = 0; r < MAX_STAKE_RUNGS; ++r) {
+        stakes[r] = std::min(initialStake * pool.ladder_[r], cap);
+        amount[r] = stakes[r];
+        lotOk[r] = pool.ladder_[r] > 0 ? 1.0 : 0.0;
+    }
+
+    std::array<StakeLanes, 3> qtys;
+    kernelLeg<(BuyMask & 1) != 0>(lots[0], quotes.bids[0], quotes.asks[0], record.feeMultipliers[0],
+                                  amount, qtys[0], lotOk);
+    kernelLeg<(BuyMask & 2) != 0>(lots[1], quotes.bids[1], quotes.asks[1], record.feeMultipliers[1],
+                                  amount, qtys[1], lotOk);
+    kernelLeg<(BuyMask & 4) != 0>(lots[2], quotes.bids[2], quotes.asks[2], record.feeMultipliers[2],
+                                  amount, qtys[2], lotOk);
+
+    // PnL-maximising rung
+    size_t best = 0;
+    double bestPnl = 0.0;
+    for (size_t r = 0; r < MAX_STAKE_RUNGS; ++r) {
+        const double pnl = lotOk[r] > 0 ? amount[r] - stakes[r] : 0.0;
+        best = pnl > bestPnl ? r : best;
+        bestPnl = std::max(bestPnl, pnl);
+    }
+
+    if (pricesValid && bestPnl > 0) [[unlikely]] {
+        std::array<double, 3> prices;
+        for (size_t leg = 0; leg < 3; ++leg) {
+            prices[leg] = record.isBuy(leg) ? quotes.asks[leg] : quotes.bids[leg];
+        }
+        return pool.makeSignal(index, prices, {qtys[0][best], qtys[1][best], qtys[2][best]}, bestPnl);
+    }
+
+    return std::nullopt;
+}
+
+EvaluateKernel ArbitragePathPool::kernelFor(uint8_t buyMask) noexcept {
+    static constexpr std::array<EvaluateKernel, 8> kernels = {
+        &evaluateKernel<0>, &evaluateKernel<1>, &evaluateKernel<2>, &evaluateKernel<3>,
+        &evaluateKernel<4>, &evaluateKernel<5>, &evaluateKernel<6>, &evaluateKernel<7>,
+    };
+    return kernels[buyMask & 7];
 }
 
-std::optional<Signal> ArbitragePath::evaluate(
+std::optional<Signal> ArbitragePathPool::evaluateVwap(
+    uint32_t index,
     double initialStake,
-    const OrderBook& orderBook,
-    const OrderSizer& orderSizer,
-    const FeeFunction& getFee) const
+    const DepthBook& depthBook,
+    const OrderSizer& orderSizer) const
 {
-    // Use mutable working buffers instead of copying orders_ vector
-    double currentAmount = initialStake;
-
-    // Fee rate as decimal (e.g., 0.001 for 0.1%)
-    const double feeRate = 1.0 - feeMultipliers_[0];
+    const PathRecord& record = records_[index];
 
+    std::array<DepthSnapshot, 3> books;
     for (size_t leg = 0; leg < 3; ++leg) {
-        const auto& order = orders_[leg];
-        const SymbolId symId = symbolIds_[leg];
+        if (!depthBook.read(record.ids[leg], books[leg])) [[unlikely]] {
+            return std::nullopt;
+        }
+    }
 
-        // Use cached prices
-        double bid = bids_[leg];
-        double ask = asks_[leg];
+    // Cap the stake by total visible depth. Converting with best-level rates
+    // over-estimates the amount reaching later legs, so the cap is conservative.
+    double cap = std::numeric_limits<double>::infinity();
+    double rate = 1.0;  // Units of this leg's input asset per unit of starting asset
+    for (size_t leg = 0; leg < 3; ++leg) {
+        const auto& book = books[leg];
+        double legCapacity = 0.0;
+        if (record.isBuy(leg)) {
+            for (uint8_t i = 0; i < book.askCount; ++i) {
+                legCapacity += book.asks[i].price * book.asks[i].qty;
+            }
+        } else {
+            for (uint8_t i = 0; i < book.bidCount; ++i) {
+                legCapacity += book.bids[i].qty;
+            }
+        }
+        cap = std::min(cap, legCapacity / rate);
+        rate *= record.isBuy(leg) ? record.feeMultipliers[leg] / book.asks[0].price
+                                  : record.feeMultipliers[leg] * book.bids[0].price;
+    }
 
-        if (bid <= 0 || ask <= 0) [[unlikely]] {
-            return std::nullopt;
+    // Each rung walks the depth on its own: fills differ per size
+    std::optional<Signal> best;
+    std::array<double, 3> prices;
+    std::array<double, 3> qtys;
+    for (size_t r = 0; r < ladderSize_; ++r) {
+        const double stake = std::min(initialStake * ladder_[r], cap);
+        const double pnl = walkDepth(index, stake, books, orderSizer, prices, qtys);
+        if (pnl > 0 && (!best || pnl > best->pnl)) [[unlikely]] {
+            best = makeSignal(index, prices, qtys, pnl);
         }
+    }
+    return best;
+}
 
-        double orderPrice = isBuy_[leg] ? ask : bid;
-        workingPrices_[leg] = orderPrice;
+double ArbitragePathPool::walkDepth(
+    uint32_t index,
+    double stake,
+    const std::array<DepthSnapshot, 3>& books,
+    const OrderSizer& orderSizer,
+    std::array<double, 3>& prices,
+    std::array<double, 3>& qtys) const
+{
+    const PathRecord& record = records_[index];
+    double currentAmount = stake;
 
-        if (isBuy_[leg]) {
-            // BUY: give quote, get base
-            // get = startingQty / ask, then apply fee to what we get
-            double rawGetQty = currentAmount / orderPrice;
-            double endingQty = rawGetQty * (1.0 - feeRate);
+    for (size_t leg = 0; leg < 3; ++leg) {
+        const SymbolId symId = record.ids[leg];
+        const auto& book = books[leg];
+
+        if (record.isBuy(leg)) {
+            // BUY: spend currentAmount of quote down the ask side
+            double remainingQuote = currentAmount;
+            double gotBase = 0.0;
+            for (uint8_t i = 0; i < book.askCount && remainingQuote > 0; ++i) {
+                const double levelCost = book.asks[i].price * book.asks[i].qty;
+                const double spend = std::min(remainingQuote, levelCost);
+                gotBase += spend / book.asks[i].price;
+                remainingQuote -= spend;
+            }
+            if (gotBase <= 0) [[unlikely]] {
+                return 0.0;
+            }
+
+            const double spent = currentAmount - std::max(remainingQuote, 0.0);
+            const double endingQty = gotBase * record.feeMultipliers[leg];
 
-            // Round ending qty to lot size for validation (using O(1) SymbolId lookup)
             double roundedEndingQty = orderSizer.hasSymbol(symId)
                 ? orderSizer.roundQuantity(symId, endingQty, true)
-                : order.getSymbol().getFilters().roundQty(endingQty);
+                : cold_[index].orders[leg].getSymbol().getFilters().roundQty(endingQty);
 
             if (roundedEndingQty <= 0) [[unlikely]] {
-                return std::nullopt;
+                return 0.0;
             }
 
-            workingQtys_[leg] = rawGetQty;
+            prices[leg] = spent / gotBase;  // VWAP
+            qtys[leg] = gotBase;
             currentAmount = endingQty;
         } else {
-            // SELL: give base, get quote
-            // Round the qty we're selling to lot size (using O(1) SymbolId lookup)
+            // SELL: give base down the bid side
             double roundedSellQty = orderSizer.hasSymbol(symId)
                 ? orderSizer.roundQuantity(symId, currentAmount, true)
-                : order.getSymbol().getFilters().roundQty(currentAmount);
+                : cold_[index].orders[leg].getSymbol().getFilters().roundQty(currentAmount);
 
             if (roundedSellQty <= 0) [[unlikely]] {
-                return std::nullopt;
+                return 0.0;
             }
 
-            double rawGetQty = roundedSellQty * orderPrice;
-            double endingQty = rawGetQty * (1.0 - feeRate);
-
-            workingQtys_[leg] = roundedSellQty;
-            currentAmount = endingQty;
-        }
-    }
+            double remainingBase = roundedSellQty;
+            double gotQuote = 0.0;
+            for (uint8_t i = 0; i < book.bidCount && remainingBase > 0; ++i) {
+                const double fill = std::min(remainingBase, book.bids[i].qty);
+                gotQuote += fill * book.bids[i].price;
+                remainingBase -= fill;
+            }
 
-    const double pnl = currentAmount - initialStake;
+            const double sold = roundedSellQty - std::max(remainingBase, 0.0);
+            if (sold <= 0) [[unlikely]] {
+                return 0.0;
+            }
 
-    if (pnl > 0) [[unlikely]] {
-        // Only create orders vector when we actually have a signal
-        std::vector<Order> signalOrders;
-        signalOrders.reserve(3);
-        for (size_t leg = 0; leg < 3; ++leg) {
-            Order o = orders_[leg];
-            o.setPrice(workingPrices_[leg]);
-            o.setQty(workingQtys_[leg]);
-            o.setType(OrderType::MARKET);
-            signalOrders.push_back(std::move(o));
+            prices[leg] = gotQuote / sold;  // VWAP
+            qtys[leg] = roundedSellQty;
+            currentAmount = gotQuote * record.feeMultipliers[leg];
         }
-        return Signal(std::move(signalOrders), cachedDescription_, pnl);
     }
 
-    return std::nullopt;
+    return currentAmount - stake;
 }
 
-// ArbitragePathPool implementation
+std::optional<Signal> ArbitragePathPool::makeSignal(
+    uint32_t index,
+    const std::array<double, 3>& prices,
+    const std::array<double, 3>& qtys,
+    double pnl) const
+{
+    // Only touch the cold table when we actually have a signal
+    const PathColdData& cold = cold_[index];
 
-size_t ArbitragePathPool::addPath(std::shared_ptr<ArbitragePath> path) {
-    size_t index = paths_.size();
-    paths_.push_back(std::move(path));
-    return index;
+    std::vector<Order> signalOrders;
+    signalOrders.reserve(3);
+    for (size_t leg = 0; leg < 3; ++leg) {
+        Order o = cold.orders[leg];
+        o.setPrice(prices[leg]);
+        o.setQty(qtys[leg]);
+        o.setType(OrderType::MARKET);
+        signalOrders.push_back(std::move(o));
+    }
+    return Signal(std::move(signalOrders), cold.description, pnl);
 }
 
 void ArbitragePathPool::buildIndex() {
-    for (auto& vec : symbolToPathIndex_) {
-        vec.clear();
+    // Counting pass, prefix sum, then fill: two passes over the paths
+    std::fill(pathOffsets_.begin(), pathOffsets_.end(), 0);
+    for (const auto& record : records_) {
+        for (SymbolId symId : record.ids) {
+            ++pathOffsets_[symId + 1];
+        }
+    }
+    for (size_t symId = 0; symId < MAX_SYMBOLS; ++symId) {
+        pathOffsets_[symId + 1] += pathOffsets_[symId];
     }
 
-    for (size_t pathIdx = 0; pathIdx < paths_.size(); ++pathIdx) {
-        const auto& path = paths_[pathIdx];
-        for (SymbolId symId : path->symbolIds()) {
-            symbolToPathIndex_[symId].push_back(pathIdx);
+    pathIndex_.resize(pathOffsets_[MAX_SYMBOLS]);
+    std::vector<uint32_t> cursor(pathOffsets_.begin(), pathOffsets_.end() - 1);
+
+    for (size_t pathIdx = 0; pathIdx < records_.size(); ++pathIdx) {
+        for (SymbolId symId : records_[pathIdx].ids) {
+            pathIndex_[cursor[symId]++] = static_cast<uint32_t>(pathIdx);
         }
     }
 
-    LOG_INFO("[ArbitragePathPool] Built index for {} paths", paths_.size());
+    seenGen_.assign(records_.size(), 0);
+    generation_ = 0;
+    affected_.clear();
+    affected_.reserve(records_.size());
+
+    matrix_.build(records_);
+
+    LOG_INFO("[ArbitragePathPool] Built index for {} paths ({} KB hot records)",
+             records_.size(), records_.size() * sizeof(PathRecord) / 1024);
 }
 
-std::vector<size_t> ArbitragePathPool::getAffectedPaths(
-    const std::bitset<MAX_SYMBOLS>& updatedSymbols) const
-{
-    std::vector<bool> affected(paths_.size(), false);
-    std::vector<size_t> result;
-    result.reserve(64);
+std::span<const uint32_t> ArbitragePathPool::getAffectedPaths(const UpdateMask& updatedSymbols) {
+    affected_.clear();
 
-    for (size_t symId = 0; symId < MAX_SYMBOLS; ++symId) {
-        if (updatedSymbols.test(symId)) {
-            const auto& pathIndices = symbolToPathIndex_[symId];
-            for (size_t pathIdx : pathIndices) {
-                if (!affected[pathIdx]) {
-                    affected[pathIdx] = true;
-                    result.push_back(pathIdx);
+    if (++generation_ == 0) [[unlikely]] {
+        std::fill(seenGen_.begin(), seenGen_.end(), 0);
+        generation_ = 1;
+    }
+
+    // Only the set bits: summary word first, then each non-empty mask word
+    for (uint64_t summary = updatedSymbols.summary; summary; summary &= summary - 1) {
+        const size_t w = std::countr_zero(summary);
+        for (uint64_t bits = updatedSymbols.words[w]; bits; bits &= bits - 1) {
+            const auto symId = static_cast<SymbolId>(w * 64 + std::countr_zero(bits));
+            for (uint32_t pathIdx : pathsForSymbol(symId)) {
+                if (seenGen_[pathIdx] != generation_) {
+                    seenGen_[pathIdx] = generation_;
+                    affected_.push_back(pathIdx);
                 }
             }
         }
     }
 
-    return result;
+    return affected_;
 }
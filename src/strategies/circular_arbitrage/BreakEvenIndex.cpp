@@ -0,0 +1,163 @@
+#include "strategies/circular_arbitrage/BreakEvenIndex.h"
+#include "strategies/circular_arbitrage/ArbitragePath.h"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace {
+    // Thresholds are built with a slightly lower ratio so that rounding in
+    // the break-even never hides a path ArbitragePathPool::refresh() would accept
+    constexpr double BREAK_EVEN_TOLERANCE = 1e-12;
+}
+
+void BreakEvenIndex::build(const ArbitragePathPool& pool, double minRatio) {
+    pool_ = &pool;
+    minRatio_ = minRatio * (1.0 - BREAK_EVEN_TOLERANCE);
+
+    sides_.assign(MAX_SYMBOLS * 2, {});
+    sellMult_.assign(MAX_SYMBOLS, 0.0);
+    buyMult_.assign(MAX_SYMBOLS, 0.0);
+    lastBid_.assign(MAX_SYMBOLS, 0.0);
+    lastAsk_.assign(MAX_SYMBOLS, 0.0);
+
+    paths_.clear();
+    paths_.reserve(pool.size());
+
+    for (size_t i = 0; i < pool.size(); ++i) {
+        const PathRecord& path = pool.record(i);
+
+        PathLegs legs{};
+        legs.ids = path.ids;
+        for (size_t leg = 0; leg < 3; ++leg) {
+            legs.isBuy[leg] = path.isBuy(leg);
+        }
+        legs.feeProduct = path.feeProduct;
+
+        // No prices yet: every threshold starts at "never"
+        for (size_t leg = 0; leg < 3; ++leg) {
+            legs.thresholds[leg] = computeThreshold(legs, leg);
+            sides_[sideIndex(legs.ids[leg], legs.isBuy[leg])].emplace(legs.thresholds[leg], static_cast<uint32_t>(i));
+        }
+
+        paths_.push_back(legs);
+    }
+
+    seenGen_.assign(paths_.size(), 0);
+    generation_ = 0;
+
+    LOG_INFO("[BreakEvenIndex] Built break-even index for {} paths", paths_.size());
+}
+
+double BreakEvenIndex::computeThreshold(const PathLegs& path, size_t leg) const noexcept {
+    double others = path.feeProduct;
+    for (size_t k = 0; k < 3; ++k) {
+        if (k != leg) {
+            others *= path.isBuy[k] ? buyMult_[path.ids[k]] : sellMult_[path.ids[k]];
+        }
+    }
+
+    if (path.isBuy[leg]) {
+        // Profitable while ask < threshold; 0 never triggers
+        return others / minRatio_;
+    }
+
+    // Profitable while bid > threshold; +inf never triggers
+    return others > 0.0 ? minRatio_ / others : std::numeric_limits<double>::infinity();
+}
+
+void BreakEvenIndex::refresh(SymbolId id, const OrderBook& orderBook) {
+    const BidAsk quote = orderBook.get(id);
+    lastBid_[id] = quote.bid;
+    lastAsk_[id] = quote.ask;
+
+    const double sellMult = quote.bid > 0.0 ? quote.bid : 0.0;
+    const double buyMult = quote.ask > 0.0 ? 1.0 / quote.ask : 0.0;
+    if (sellMult == sellMult_[id] && buyMult == buyMult_[id]) {
+        return;  // Size-only update: no threshold depends on it
+    }
+    sellMult_[id] = sellMult;
+    buyMult_[id] = buyMult;
+
+    // This symbol's own thresholds are unchanged; reposition the other legs
+    for (uint32_t pathIdx : pool_->pathsForSymbol(id)) {
+        PathLegs& path = paths_[pathIdx];
+
+        for (size_t leg = 0; leg < 3; ++leg) {
+            if (path.ids[leg] == id) {
+                continue;
+            }
+
+            const double threshold = computeThreshold(path, leg);
+            if (threshold == path.thresholds[leg]) {
+                continue;
+            }
+
+            auto& side = sides_[sideIndex(path.ids[leg], path.isBuy[leg])];
+            auto node = side.extract({path.thresholds[leg], static_cast<uint32_t>(pathIdx)});
+            node.value().first = threshold;
+            side.insert(std::move(node));
+            path.thresholds[leg] = threshold;
+        }
+    }
+}
+
+void BreakEvenIndex::query(SymbolId id, std::vector<uint32_t>& out, bool dedupe) {
+    auto emit = [&](uint32_t pathIdx) {
+        if (dedupe) {
+            if (seenGen_[pathIdx] == generation_) {
+                return;
+            }
+            seenGen_[pathIdx] = generation_;
+        }
+        out.push_back(pathIdx);
+    };
+
+    // SELL legs on this symbol: thresholds ascending, hits are at the front
+    const double bid = lastBid_[id];
+    if (bid > 0.0) {
+        const auto& sells = sides_[sideIndex(id, false)];
+        for (auto it = sells.begin(); it != sells.end() && it->first < bid; ++it) {
+            emit(it->second);
+        }
+    }
+
+    // BUY legs on this symbol: hits are at the back
+    const double ask = lastAsk_[id];
+    if (ask > 0.0) {
+        const auto& buys = sides_[sideIndex(id, true)];
+        for (auto it = buys.rbegin(); it != buys.rend() && it->first > ask; ++it) {
+            emit(it->second);
+        }
+    }
+}
+
+void BreakEvenIndex::onSymbolUpdate(SymbolId id, const OrderBook& orderBook, std::vector<uint32_t>& out) {
+    out.clear();
+    refresh(id, orderBook);
+    query(id, out, false);
+}
+
+void BreakEvenIndex::onUpdates(const UpdateMask& updated, const OrderBook& orderBook, std::vector<uint32_t>& out) {
+    out.clear();
+
+    // Refresh everything first so each threshold sees all new prices
+    for (uint64_t summary = updated.summary; summary; summary &= summary - 1) {
+        const size_t w = std::countr_zero(summary);
+        for (uint64_t bits = updated.words[w]; bits; bits &= bits - 1) {
+            refresh(static_cast<SymbolId>(w * 64 + std::countr_zero(bits)), orderBook);
+        }
+    }
+
+    if (++generation_ == 0) [[unlikely]] {
+        std::fill(seenGen_.begin(), seenGen_.end(), 0);
+        generation_ = 1;
+    }
+    for (uint64_t summary = updated.summary; summary; summary &= summary - 1) {
+        const size_t w = std::countr_zero(summary);
+        for (uint64_t bits = updated.words[w]; bits; bits &= bits - 1) {
+            query(static_cast<SymbolId>(w * 64 + std::countr_zero(bits)), out, true);
+        }
+    }
+}
@@ -0,0 +1,398 @@
+#include "strategies/circular_arbitrage/CycleEngine.h"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    constexpr double NO_EDGE = std::numeric_limits<double>::infinity();
+    constexpr uint32_t UNREACHED = std::numeric_limits<uint32_t>::max();
+
+    // Keeps cycles within rounding of minRatio; the sized evaluation decides
+    constexpr double CYCLE_TOLERANCE = 1e-12;
+}
+
+CycleEngine::CycleEngine(int minLegs, int maxLegs)
+    : minLegs_(minLegs)
+    , maxLegs_(maxLegs)
+{
+    if (minLegs_ < 2 || maxLegs_ > MAX_CYCLE_LEGS || minLegs_ > maxLegs_) {
+        throw std::runtime_error("CycleEngine: cycle length must be within [2, " +
+                                 std::to_string(MAX_CYCLE_LEGS) + "]");
+    }
+}
+
+void CycleEngine::build(
+    const std::vector<fin::Symbol>& symbols,
+    const std::string& startingAsset,
+    const FeeFunction& getFee)
+{
+    // Asset nodes
+    std::map<std::string, uint32_t> assetIndex;
+    auto nodeOf = [&](const std::string& asset) {
+        auto [it, inserted] = assetIndex.emplace(asset, static_cast<uint32_t>(assetIndex.size()));
+        return it->second;
+    };
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;  // (base, quote) per symbol
+    pairs.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        pairs.emplace_back(nodeOf(symbol.getBase()), nodeOf(symbol.getQuote()));
+    }
+
+    const auto startIt = assetIndex.find(startingAsset);
+    const size_t nodeCount = assetIndex.size();
+
+    symbols_.clear();
+    symbolNames_.clear();
+    edges_.clear();
+    symbolEdge_.assign(MAX_SYMBOLS, -1);
+
+    if (startIt == assetIndex.end()) {
+        LOG_WARNING("[CycleEngine] Starting asset {} not found in any symbol", startingAsset);
+        return;
+    }
+    start_ = startIt->second;
+
+    // Hop distance from the starting asset (the graph is symmetric)
+    std::vector<std::vector<uint32_t>> neighbours(nodeCount);
+    for (const auto& [base, quote] : pairs) {
+        neighbours[base].push_back(quote);
+        neighbours[quote].push_back(base);
+    }
+    std::vector<uint32_t> hops(nodeCount, UNREACHED);
+    std::queue<uint32_t> frontier;
+    hops[start_] = 0;
+    frontier.push(start_);
+    while (!frontier.empty()) {
+        const uint32_t u = frontier.front();
+        frontier.pop();
+        for (uint32_t v : neighbours[u]) {
+            if (hops[v] == UNREACHED) {
+                hops[v] = hops[u] + 1;
+                frontier.push(v);
+            }
+        }
+    }
+
+    // Keep symbols that fit on a cycle of at most maxLegs: out to one end,
+    // across the symbol, back from the other end
+    auto& registry = SymbolRegistry::instance();
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const auto [base, quote] = pairs[i];
+        if (hops[base] == UNREACHED || hops[quote] == UNREACHED ||
+            hops[base] + 1 + hops[quote] > static_cast<uint32_t>(maxLegs_)) {
+            continue;
+        }
+
+        const std::string& name = symbols[i].to_str();
+        const SymbolId id = registry.registerSymbol(name);
+        if (symbolEdge_[id] >= 0) {
+            continue;  // Duplicate listing
+        }
+
+        const double feeMultiplier = 1.0 - getFee(name) / 100.0;
+        const uint32_t symbolIdx = static_cast<uint32_t>(symbols_.size());
+        symbols_.push_back(symbols[i]);
+        symbolNames_.insert(name);
+
+        symbolEdge_[id] = static_cast<int32_t>(edges_.size());
+        edges_.push_back({base, quote, symbolIdx, id, false, -std::log(feeMultiplier), feeMultiplier});
+        edges_.push_back({quote, base, symbolIdx, id, true, -std::log(feeMultiplier), feeMultiplier});
+    }
+
+    // CSR adjacency
+    auto buildCsr = [&](std::vector<uint32_t>& offsets, std::vector<uint32_t>& list, bool byHead) {
+        offsets.assign(nodeCount + 1, 0);
+        for (const auto& e : edges_) {
+            ++offsets[(byHead ? e.to : e.from) + 1];
+        }
+        for (size_t v = 0; v < nodeCount; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        list.resize(edges_.size());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (uint32_t e = 0; e < edges_.size(); ++e) {
+            list[cursor[byHead ? edges_[e].to : edges_[e].from]++] = e;
+        }
+    };
+    buildCsr(inStart_, inEdges_, true);
+    buildCsr(outStart_, outEdges_, false);
+
+    // No prices yet: every edge and every walk is unusable
+    weights_.assign(edges_.size(), NO_EDGE);
+    for (int k = 0; k < maxLegs_; ++k) {
+        dist_[k].assign(nodeCount, NO_EDGE);
+        pred_[k].assign(nodeCount, -1);
+    }
+    dist_[0][start_] = 0.0;
+
+    nodeStamp_.assign(nodeCount, 0);
+    stamp_ = 0;
+    touched_.clear();
+    touched_.reserve(edges_.size());
+    cycle_.reserve(MAX_CYCLE_LEGS);
+
+    LOG_INFO("[CycleEngine] Built asset graph from {}: {} assets, {} symbols, {} edges, cycles of {}-{} legs",
+             startingAsset, nodeCount, symbols_.size(), edges_.size(), minLegs_, maxLegs_);
+}
+
+void CycleEngine::refresh(SymbolId id, const OrderBook& orderBook) {
+    const int32_t first = symbolEdge_[id];
+    if (first < 0) {
+        return;
+    }
+
+    const BidAsk quote = orderBook.get(id);
+    const uint32_t sell = static_cast<uint32_t>(first);
+    const uint32_t buy = sell + 1;
+
+    const double sellWeight = quote.bid > 0.0 ? edges_[sell].logFee - std::log(quote.bid) : NO_EDGE;
+    const double buyWeight = quote.ask > 0.0 ? edges_[buy].logFee + std::log(quote.ask) : NO_EDGE;
+
+    if (sellWeight != weights_[sell]) {
+        weights_[sell] = sellWeight;
+        touched_.push_back(sell);
+    }
+    if (buyWeight != weights_[buy]) {
+        weights_[buy] = buyWeight;
+        touched_.push_back(buy);
+    }
+}
+
+void CycleEngine::onSymbolUpdate(SymbolId id, const OrderBook& orderBook) {
+    refresh(id, orderBook);
+    relax();
+}
+
+void CycleEngine::onUpdates(const UpdateMask& updated, const OrderBook& orderBook) {
+    for (uint64_t summary = updated.summary; summary; summary &= summary - 1) {
+        const size_t w = std::countr_zero(summary);
+        for (uint64_t bits = updated.words[w]; bits; bits &= bits - 1) {
+            refresh(static_cast<SymbolId>(w * 64 + std::countr_zero(bits)), orderBook);
+        }
+    }
+    relax();
+}
+
+void CycleEngine::markDirty(uint32_t node) {
+    if (nodeStamp_[node] != stamp_) {
+        nodeStamp_[node] = stamp_;
+        dirty_.push_back(node);
+    }
+}
+
+void CycleEngine::relax() {
+    if (touched_.empty()) {
+        return;
+    }
+
+    changed_.clear();  // Layer 0 never changes
+
+    for (int k = 1; k < maxLegs_; ++k) {
+        ++stamp_;
+        dirty_.clear();
+
+        // Heads of re-weighted edges, and successors of nodes that moved
+        for (uint32_t e : touched_) {
+            markDirty(edges_[e].to);
+        }
+        for (uint32_t u : changed_) {
+            for (uint32_t i = outStart_[u]; i < outStart_[u + 1]; ++i) {
+                markDirty(edges_[outEdges_[i]].to);
+            }
+        }
+
+        const auto& prev = dist_[k - 1];
+        auto& dist = dist_[k];
+        auto& pred = pred_[k];
+        nextChanged_.clear();
+
+        for (uint32_t v : dirty_) {
+            double best = NO_EDGE;
+            int32_t bestEdge = -1;
+            for (uint32_t i = inStart_[v]; i < inStart_[v + 1]; ++i) {
+                const uint32_t e = inEdges_[i];
+                const double d = prev[edges_[e].from] + weights_[e];
+                if (d < best) {
+                    best = d;
+                    bestEdge = static_cast<int32_t>(e);
+                }
+            }
+
+            pred[v] = bestEdge;
+            if (best != dist[v]) {
+                dist[v] = best;
+                nextChanged_.push_back(v);
+            }
+        }
+
+        changed_.swap(nextChanged_);
+    }
+
+    touched_.clear();
+}
+
+bool CycleEngine::rebuildCycle(uint32_t closingEdge, int legs) {
+    cycle_.assign(static_cast<size_t>(legs), 0);
+    cycle_[legs - 1] = closingEdge;
+
+    uint32_t node = edges_[closingEdge].from;
+    for (int k = legs - 1; k >= 1; --k) {
+        const int32_t e = pred_[k][node];
+        if (e < 0) {
+            return false;
+        }
+        cycle_[k - 1] = static_cast<uint32_t>(e);
+        node = edges_[e].from;
+    }
+    if (node != start_) {
+        return false;
+    }
+
+    // Simple cycle only: no asset entered twice, no symbol traded twice
+    for (int i = 0; i < legs; ++i) {
+        for (int j = i + 1; j < legs; ++j) {
+            if (edges_[cycle_[i]].to == edges_[cycle_[j]].to ||
+                edges_[cycle_[i]].symbolIdx == edges_[cycle_[j]].symbolIdx) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::optional<Signal> CycleEngine::findSignal(
+    double minRatio,
+    double initialStake,
+    const OrderBook& orderBook,
+    const OrderSizer& orderSizer)
+{
+    if (edges_.empty()) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    const double threshold = -std::log(minRatio) + CYCLE_TOLERANCE;
+
+    double bestWeight = threshold;
+    int32_t bestEdge = -1;
+    int bestLegs = 0;
+
+    for (int legs = minLegs_; legs <= maxLegs_; ++legs) {
+        const auto& prev = dist_[legs - 1];
+        for (uint32_t i = inStart_[start_]; i < inStart_[start_ + 1]; ++i) {
+            const uint32_t e = inEdges_[i];
+            const double weight = prev[edges_[e].from] + weights_[e];
+            if (weight < bestWeight) [[unlikely]] {
+                bestWeight = weight;
+                bestEdge = static_cast<int32_t>(e);
+                bestLegs = legs;
+            }
+        }
+    }
+
+    if (bestEdge < 0) [[likely]] {
+        return std::nullopt;
+    }
+
+    if (!rebuildCycle(static_cast<uint32_t>(bestEdge), bestLegs)) {
+        LOG_DEBUG("[CycleEngine] Best {}-leg walk (ratio {:.6f}) is not a simple cycle",
+                  bestLegs, std::exp(-bestWeight));
+        return std::nullopt;
+    }
+
+    return evaluateCycle(initialStake, orderBook, orderSizer);
+}
+
+std::optional<Signal> CycleEngine::evaluateCycle(
+    double initialStake,
+    const OrderBook& orderBook,
+    const OrderSizer& orderSizer) const
+{
+    const size_t legs = cycle_.size();
+
+    std::array<BidAsk, MAX_CYCLE_LEGS> quotes;
+    for (size_t leg = 0; leg < legs; ++leg) {
+        quotes[leg] = orderBook.get(edges_[cycle_[leg]].symbolId);
+        if (quotes[leg].bid <= 0 || quotes[leg].ask <= 0) [[unlikely]] {
+            return std::nullopt;
+        }
+    }
+
+    // Never size beyond what the best levels can absorb (as ArbitragePathPool)
+    double stake = initialStake;
+    double rate = 1.0;
+    for (size_t leg = 0; leg < legs; ++leg) {
+        const Edge& edge = edges_[cycle_[leg]];
+        const BidAsk& q = quotes[leg];
+        const double levelQty = edge.isBuy ? q.askQty : q.bidQty;
+        if (levelQty > 0 && rate > 0) {
+            const double legCapacity = edge.isBuy ? levelQty * q.ask : levelQty;
+            stake = std::min(stake, legCapacity / rate);
+        }
+        rate *= (edge.isBuy ? 1.0 / q.ask : q.bid) * edge.feeMultiplier;
+    }
+
+    std::array<double, MAX_CYCLE_LEGS> prices;
+    std::array<double, MAX_CYCLE_LEGS> qtys;
+    double currentAmount = stake;
+
+    for (size_t leg = 0; leg < legs; ++leg) {
+        const Edge& edge = edges_[cycle_[leg]];
+        const fin::Symbol& symbol = symbols_[edge.symbolIdx];
+        const double price = edge.isBuy ? quotes[leg].ask : quotes[leg].bid;
+        prices[leg] = price;
+
+        if (edge.isBuy) {
+            // BUY: give quote, get base; fee on what we get
+            const double rawGetQty = currentAmount / price;
+            const double endingQty = rawGetQty * edge.feeMultiplier;
+
+            const double roundedEndingQty = orderSizer.hasSymbol(edge.symbolId)
+                ? orderSizer.roundQuantity(edge.symbolId, endingQty, true)
+                : symbol.getFilters().roundQty(endingQty);
+            if (roundedEndingQty <= 0) [[unlikely]] {
+                return std::nullopt;
+            }
+
+            qtys[leg] = rawGetQty;
+            currentAmount = endingQty;
+        } else {
+            // SELL: give base, get quote
+            const double roundedSellQty = orderSizer.hasSymbol(edge.symbolId)
+                ? orderSizer.roundQuantity(edge.symbolId, currentAmount, true)
+                : symbol.getFilters().roundQty(currentAmount);
+            if (roundedSellQty <= 0) [[unlikely]] {
+                return std::nullopt;
+            }
+
+            qtys[leg] = roundedSellQty;
+            currentAmount = roundedSellQty * price * edge.feeMultiplier;
+        }
+    }
+
+    const double pnl = currentAmount - stake;
+    if (pnl <= 0) [[likely]] {
+        return std::nullopt;
+    }
+
+    std::vector<Order> orders;
+    orders.reserve(legs);
+    std::ostringstream description;
+    for (size_t leg = 0; leg < legs; ++leg) {
+        const Edge& edge = edges_[cycle_[leg]];
+        Order order(symbols_[edge.symbolIdx], edge.isBuy ? Way::BUY : Way::SELL,
+                    OrderType::MARKET, qtys[leg], prices[leg]);
+        if (leg > 0) description << " ";
+        description << order.to_str();
+        orders.push_back(std::move(order));
+    }
+
+    return Signal(std::move(orders), description.str(), pnl);
+}
@@ -0,0 +1,153 @@
+#include "strategies/circular_arbitrage/PathMatrix.h"
+#include "strategies/circular_arbitrage/ArbitragePath.h"
+#include "logger.hpp"
+
+#include <bit>
+#include <cstring>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Relative slack on the threshold; far above the few-ulp difference
+    // between this product and ArbitragePathPool::refresh(), far below any real edge
+    constexpr double SCREEN_TOLERANCE = 1e-12;
+
+    const char* kernelName() {
+#if defined(__AVX512F__)
+        return "AVX-512";
+#elif defined(__AVX2__)
+        return "AVX2";
+#else
+        return "scalar";
+#endif
+    }
+}
+
+void PathMatrix::build(const std::vector<PathRecord>& paths) {
+    pathCount_ = paths.size();
+    const size_t padded = (pathCount_ + PATH_MATRIX_LANES - 1) / PATH_MATRIX_LANES * PATH_MATRIX_LANES;
+
+    for (auto& offsets : legOffsets_) {
+        offsets.assign(padded, PRICE_SLOT_BID_OFFSET);  // Padding reads slot 0, masked by fee 0
+    }
+    dirMasks_.assign(padded, 0);
+    feeProducts_.assign(padded, 0.0);
+
+    for (size_t i = 0; i < pathCount_; ++i) {
+        const PathRecord& path = paths[i];
+
+        for (size_t leg = 0; leg < 3; ++leg) {
+            legOffsets_[leg][i] = static_cast<int32_t>(path.ids[leg]) * PRICE_SLOT_STRIDE +
+                                  (path.isBuy(leg) ? PRICE_SLOT_ASK_OFFSET : PRICE_SLOT_BID_OFFSET);
+        }
+        dirMasks_[i] = path.buyMask;
+        feeProducts_[i] = path.feeProduct;
+    }
+
+    LOG_INFO("[PathMatrix] Built {} paths ({} padded), {} kernel", pathCount_, padded, kernelName());
+}
+
+void PathMatrix::screenScalar(const double* prices, double threshold, std::vector<uint32_t>& out) const {
+    for (size_t i = 0; i < pathCount_; ++i) {
+        double num = feeProducts_[i];
+        double den = threshold;
+        bool valid = true;
+
+        for (size_t leg = 0; leg < 3; ++leg) {
+            const double p = prices[legOffsets_[leg][i]];
+            valid &= p > 0.0;
+            if ((dirMasks_[i] >> leg) & 1) {
+                den *= p;
+            } else {
+                num *= p;
+            }
+        }
+
+        if (valid && num > den) {
+            out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void PathMatrix::screen(const OrderBook& orderBook, double minRatio, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (pathCount_ == 0) {
+        return;
+    }
+
+    const double* prices = orderBook.rawPrices();
+    const double threshold = minRatio * (1.0 - SCREEN_TOLERANCE);
+
+#if defined(__AVX512F__)
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d thr = _mm512_set1_pd(threshold);
+
+    for (size_t i = 0; i < pathCount_; i += 8) {
+        const __m512i dirs = _mm512_cvtepu8_epi64(_mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(&dirMasks_[i])));
+
+        __m512d num = _mm512_loadu_pd(&feeProducts_[i]);
+        __m512d den = thr;
+        __mmask8 valid = 0xFF;
+
+        for (int leg = 0; leg < 3; ++leg) {
+            const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&legOffsets_[leg][i]));
+            const __m512d p = _mm512_i32gather_pd(idx, prices, 8);
+            const __mmask8 buy = _mm512_test_epi64_mask(dirs, _mm512_set1_epi64(1LL << leg));
+
+            valid &= _mm512_cmp_pd_mask(p, zero, _CMP_GT_OQ);
+            den = _mm512_mask_mul_pd(den, buy, den, p);
+            num = _mm512_mask_mul_pd(num, static_cast<__mmask8>(~buy), num, p);
+        }
+
+        uint32_t hits = valid & _mm512_cmp_pd_mask(num, den, _CMP_GT_OQ);
+        while (hits) [[unlikely]] {
+            const size_t idx = i + std::countr_zero(hits);
+            if (idx < pathCount_) {
+                out.push_back(static_cast<uint32_t>(idx));
+            }
+            hits &= hits - 1;
+        }
+    }
+#elif defined(__AVX2__)
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d thr = _mm256_set1_pd(threshold);
+
+    for (size_t i = 0; i < pathCount_; i += 4) {
+        int32_t dirBytes;
+        std::memcpy(&dirBytes, &dirMasks_[i], sizeof(dirBytes));
+        const __m128i dirs = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(dirBytes));
+
+        __m256d num = _mm256_loadu_pd(&feeProducts_[i]);
+        __m256d den = thr;
+        __m256d valid = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+        for (int leg = 0; leg < 3; ++leg) {
+            const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&legOffsets_[leg][i]));
+            const __m256d p = _mm256_i32gather_pd(prices, idx, 8);
+
+            const __m128i bit = _mm_set1_epi32(1 << leg);
+            const __m256d buy = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(
+                _mm_cmpeq_epi32(_mm_and_si128(dirs, bit), bit)));
+
+            valid = _mm256_and_pd(valid, _mm256_cmp_pd(p, zero, _CMP_GT_OQ));
+            den = _mm256_mul_pd(den, _mm256_blendv_pd(one, p, buy));
+            num = _mm256_mul_pd(num, _mm256_blendv_pd(p, one, buy));
+        }
+
+        int hits = _mm256_movemask_pd(_mm256_and_pd(valid, _mm256_cmp_pd(num, den, _CMP_GT_OQ)));
+        while (hits) [[unlikely]] {
+            const size_t idx = i + std::countr_zero(static_cast<unsigned>(hits));
+            if (idx < pathCount_) {
+                out.push_back(static_cast<uint32_t>(idx));
+            }
+            hits &= hits - 1;
+        }
+    }
+#else
+    screenScalar(prices, threshold, out);
+#endif
+}
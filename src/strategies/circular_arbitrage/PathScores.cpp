@@ -0,0 +1,166 @@
+#include "strategies/circular_arbitrage/PathScores.h"
+#include "strategies/circular_arbitrage/ArbitragePath.h"
+#include "logger.hpp"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr double NO_PRICE = -std::numeric_limits<double>::infinity();
+
+    // Keeps ratios within rounding of minRatio in the candidate set;
+    // candidates are re-checked with ArbitragePathPool::refresh()
+    constexpr double SCORE_TOLERANCE = 1e-12;
+}
+
+void PathScores::build(const ArbitragePathPool& pool) {
+    pool_ = &pool;
+    const size_t count = pool.size();
+
+    legIds_.resize(count);
+    dirMasks_.assign(count, 0);
+    logFees_.resize(count);
+    scores_.assign(count, NO_PRICE);
+    touchedGen_.assign(count, 0);
+    generation_ = 1;
+
+    logSell_.assign(MAX_SYMBOLS, NO_PRICE);
+    logBuy_.assign(MAX_SYMBOLS, NO_PRICE);
+
+    heap_.resize(count);
+    heapPos_.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const PathRecord& path = pool.record(i);
+        const auto& fees = path.feeMultipliers;
+
+        legIds_[i] = path.ids;
+        logFees_[i] = std::log(fees[0]) + std::log(fees[1]) + std::log(fees[2]);
+        dirMasks_[i] = path.buyMask;
+
+        // All scores start at -inf, any order is a valid heap
+        heap_[i] = static_cast<uint32_t>(i);
+        heapPos_[i] = static_cast<uint32_t>(i);
+    }
+
+    LOG_INFO("[PathScores] Built log-score heap for {} paths", count);
+}
+
+double PathScores::computeScore(size_t pathIdx) const noexcept {
+    const auto& ids = legIds_[pathIdx];
+    const uint8_t dirs = dirMasks_[pathIdx];
+
+    double score = logFees_[pathIdx];
+    for (size_t leg = 0; leg < 3; ++leg) {
+        score += ((dirs >> leg) & 1) ? logBuy_[ids[leg]] : logSell_[ids[leg]];
+    }
+    return score;
+}
+
+void PathScores::refresh(SymbolId id, const OrderBook& orderBook) {
+    const BidAsk quote = orderBook.get(id);
+    const double logSell = quote.bid > 0.0 ? std::log(quote.bid) : NO_PRICE;
+    const double logBuy = quote.ask > 0.0 ? -std::log(quote.ask) : NO_PRICE;
+
+    if (logSell == logSell_[id] && logBuy == logBuy_[id]) {
+        return;  // Size-only update
+    }
+    logSell_[id] = logSell;
+    logBuy_[id] = logBuy;
+
+    for (uint32_t pathIdx : pool_->pathsForSymbol(id)) {
+        const double previous = scores_[pathIdx];
+        const double score = computeScore(pathIdx);
+        scores_[pathIdx] = score;
+        touchedGen_[pathIdx] = generation_;
+
+        if (score > previous) {
+            siftUp(heapPos_[pathIdx]);
+        } else if (score < previous) {
+            siftDown(heapPos_[pathIdx]);
+        }
+    }
+}
+
+void PathScores::onSymbolUpdate(SymbolId id, const OrderBook& orderBook) {
+    refresh(id, orderBook);
+}
+
+void PathScores::onUpdates(const UpdateMask& updated, const OrderBook& orderBook) {
+    for (uint64_t summary = updated.summary; summary; summary &= summary - 1) {
+        const size_t w = std::countr_zero(summary);
+        for (uint64_t bits = updated.words[w]; bits; bits &= bits - 1) {
+            refresh(static_cast<SymbolId>(w * 64 + std::countr_zero(bits)), orderBook);
+        }
+    }
+}
+
+void PathScores::collect(double minRatio, std::vector<uint32_t>& out) {
+    out.clear();
+
+    const double threshold = std::log(minRatio) - SCORE_TOLERANCE;
+
+    // Common case: nothing above the threshold, O(1)
+    if (!heap_.empty() && scores_[heap_[0]] > threshold) [[unlikely]] {
+        dfsStack_.clear();
+        dfsStack_.push_back(0);
+
+        while (!dfsStack_.empty()) {
+            const uint32_t pos = dfsStack_.back();
+            dfsStack_.pop_back();
+
+            const uint32_t pathIdx = heap_[pos];
+            if (!(scores_[pathIdx] > threshold)) {
+                continue;  // Whole subtree is below
+            }
+
+            // Only paths that moved this round, as in the rescreen mode
+            if (touchedGen_[pathIdx] == generation_) {
+                out.push_back(pathIdx);
+            }
+
+            const uint32_t left = 2 * pos + 1;
+            if (left < heap_.size()) dfsStack_.push_back(left);
+            if (left + 1 < heap_.size()) dfsStack_.push_back(left + 1);
+        }
+    }
+
+    ++generation_;
+}
+
+void PathScores::swapNodes(uint32_t a, uint32_t b) noexcept {
+    std::swap(heap_[a], heap_[b]);
+    heapPos_[heap_[a]] = a;
+    heapPos_[heap_[b]] = b;
+}
+
+void PathScores::siftUp(uint32_t pos) noexcept {
+    while (pos > 0) {
+        const uint32_t parent = (pos - 1) / 2;
+        if (!(scores_[heap_[pos]] > scores_[heap_[parent]])) {
+            break;
+        }
+        swapNodes(pos, parent);
+        pos = parent;
+    }
+}
+
+void PathScores::siftDown(uint32_t pos) noexcept {
+    const uint32_t size = static_cast<uint32_t>(heap_.size());
+    while (true) {
+        const uint32_t left = 2 * pos + 1;
+        if (left >= size) {
+            break;
+        }
+        uint32_t best = left;
+        if (left + 1 < size && scores_[heap_[left + 1]] > scores_[heap_[left]]) {
+            best = left + 1;
+        }
+        if (!(scores_[heap_[best]] > scores_[heap_[pos]])) {
+            break;
+        }
+        swapNodes(pos, best);
+        pos = best;
+    }
+}
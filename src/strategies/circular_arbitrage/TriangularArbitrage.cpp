@@ -2,12 +2,72 @@
 #include "logger.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    const char* detectionModeName(DetectionMode mode) {
+        switch (mode) {
+            case DetectionMode::BreakEven: return "break_even";
+            case DetectionMode::LogScore:  return "log_score";
+            case DetectionMode::Rescreen:
+            default:                       return "rescreen";
+        }
+    }
+
+    // Same legs and directions in any rotation: one cycle, whatever the starting asset
+    std::string cycleKey(const std::vector<fin::Symbol>& symbols, const RouteDescriptor& route) {
+        std::vector<std::string> legs;
+        legs.reserve(route.symbols.size());
+        for (size_t leg = 0; leg < route.symbols.size(); ++leg) {
+            legs.push_back(symbols[route.symbols[leg]].to_str() + (route.isBuy[leg] ? ":B" : ":S"));
+        }
+        std::sort(legs.begin(), legs.end());
+
+        std::string key;
+        for (const auto& leg : legs) {
+            key += leg;
+            key += ' ';
+        }
+        return key;
+    }
+
+    // Below this many first legs per thread, spawning costs more than it saves
+    constexpr size_t MIN_FIRST_LEGS_PER_THREAD = 16;
+
+    /**
+     * CSR asset -> symbol index. Legs of asset a are legs[offsets[a] .. offsets[a+1]),
+     * in exchange symbol order: SELL where a is the base, BUY where it is the quote.
+     */
+    struct AssetAdjacency {
+        struct Leg {
+            uint32_t symbol;
+            uint32_t to;
+            bool isBuy;
+        };
+
+        std::vector<uint32_t> offsets;
+        std::vector<Leg> legs;
+
+        [[nodiscard]] const Leg* begin(uint32_t asset) const { return legs.data() + offsets[asset]; }
+        [[nodiscard]] const Leg* end(uint32_t asset) const { return legs.data() + offsets[asset + 1]; }
+    };
+
+    // Above 1/N of the paths affected, screening every path in SIMD is
+    // cheaper than refreshing the affected paths one record at a time
+    constexpr size_t FULL_SCREEN_DIVISOR = 4;
+}
 
 TriangularArbitrage::TriangularArbitrage(const TriangularArbitrageConfig& config)
     : startingAsset_(config.startingAsset)
     , defaultFee_(config.defaultFee)
     , risk_(config.risk)
     , minProfitRatio_(config.minProfitRatio)
+    , detectionMode_(config.detectionMode)
+    , maxLegs_(std::clamp(config.maxLegs, 3, CycleEngine::MAX_CYCLE_LEGS))
+    , logPaths_(config.logPaths)
+    , stakeLadder_(config.stakeLadder)
     , symbolFees_(config.symbolFees)
 {
     // Cache the fee function
@@ -15,8 +75,18 @@ TriangularArbitrage::TriangularArbitrage(const TriangularArbitrageConfig& config
         return getFeeForSymbol(symbol);
     };
 
-    LOG_INFO("[TriangularArbitrage] Created with starting asset: {}, defaultFee: {}%, risk: {}, minProfitRatio: {}",
-             startingAsset_, defaultFee_, risk_, minProfitRatio_);
+    LOG_INFO("[TriangularArbitrage] Created with starting asset: {}, defaultFee: {}%, risk: {}, minProfitRatio: {}, detection: {}, maxLegs: {}",
+             startingAsset_, defaultFee_, risk_, minProfitRatio_, detectionModeName(detectionMode_), maxLegs_);
+
+    if (stakeLadder_.size() > ArbitragePathPool::MAX_STAKE_RUNGS) {
+        LOG_WARNING("[TriangularArbitrage] Stake ladder has {} rungs, keeping the first {}",
+                    stakeLadder_.size(), ArbitragePathPool::MAX_STAKE_RUNGS);
+        stakeLadder_.resize(ArbitragePathPool::MAX_STAKE_RUNGS);
+    }
+    if (!stakeLadder_.empty()) {
+        LOG_INFO("[TriangularArbitrage] Stake ladder: {} rungs, {:.4f} .. {:.4f} of the stake",
+                 stakeLadder_.size(), stakeLadder_.front(), stakeLadder_.back());
+    }
 }
 
 double TriangularArbitrage::getFeeForSymbol(const std::string& symbol) const {
@@ -24,34 +94,79 @@ double TriangularArbitrage::getFeeForSymbol(const std::string& symbol) const {
     return (it != symbolFees_.end()) ? it->second : defaultFee_;
 }
 
-void TriangularArbitrage::discoverRoutes(const std::vector<fin::Symbol>& symbols) {
+void TriangularArbitrage::discoverRoutes(
+    const std::vector<fin::Symbol>& symbols,
+    std::set<std::string>* claimedCycles)
+{
     LOG_INFO("[TriangularArbitrage] Discovering arbitrage routes...");
     LOG_INFO("[TriangularArbitrage] Using {} symbols from exchange info", symbols.size());
 
-    auto stratPaths = computeArbitragePaths(symbols, startingAsset_, 3);
+    auto routes = computeArbitragePaths(symbols, startingAsset_);
+
+    size_t duplicates = 0;
+    if (claimedCycles) {
+        std::erase_if(routes, [&](const RouteDescriptor& route) {
+            const bool claimed = !claimedCycles->insert(cycleKey(symbols, route)).second;
+            duplicates += claimed ? 1 : 0;
+            return claimed;
+        });
+        LOG_INFO("[TriangularArbitrage] {} cycles already owned by other starting assets", duplicates);
+    }
+
+    routes_ = std::move(routes);
+    buildPool(symbols);
+}
 
+void TriangularArbitrage::loadRoutes(const std::vector<fin::Symbol>& symbols, std::vector<RouteDescriptor> routes) {
+    LOG_INFO("[TriangularArbitrage] Loading {} cached routes", routes.size());
+    routes_ = std::move(routes);
+    buildPool(symbols);
+}
+
+void TriangularArbitrage::buildPool(const std::vector<fin::Symbol>& symbols) {
     stratSymbols_.clear();
 
-    for (auto& pathOrders : stratPaths) {
-        auto path = std::make_shared<ArbitragePath>(pathOrders.orders(), feeFunction_);
-        pathPool_.addPath(path);
+    for (const auto& route : routes_) {
+        std::vector<Order> pathOrders;
+        pathOrders.reserve(3);
+        for (size_t leg = 0; leg < 3; ++leg) {
+            pathOrders.emplace_back(symbols[route.symbols[leg]], route.isBuy[leg] ? Way::BUY : Way::SELL);
+        }
+
+        pathPool_.addPath(std::move(pathOrders), feeFunction_);
 
-        for (const auto& symbol : path->symbols()) {
-            stratSymbols_.insert(symbol);
+        for (uint32_t symbolIdx : route.symbols) {
+            stratSymbols_.insert(symbols[symbolIdx].to_str());
         }
     }
 
     // Build inverted index for fast affected path lookup
     pathPool_.buildIndex();
+    pathPool_.setStakeLadder(stakeLadder_);
+
+    if (detectionMode_ == DetectionMode::BreakEven) {
+        breakEvenIndex_.build(pathPool_, minProfitRatio_);
+    } else if (detectionMode_ == DetectionMode::LogScore) {
+        pathPool_.buildScores();
+    }
+
+    if (maxLegs_ > 3) {
+        cycleEngine_ = std::make_unique<CycleEngine>(4, maxLegs_);
+        cycleEngine_->build(symbols, startingAsset_, feeFunction_);
+        stratSymbols_.insert(cycleEngine_->symbols().begin(), cycleEngine_->symbols().end());
+    }
 
     LOG_INFO("[TriangularArbitrage] Found {} arbitrage paths, {} unique symbols",
              pathPool_.size(), stratSymbols_.size());
 
+    if (!logPaths_) {
+        return;
+    }
+
     // Log all discovered paths with their IDs
     LOG_INFO("[TriangularArbitrage] ========== ARBITRAGE PATHS ==========");
-    size_t pathId = 0;
-    for (auto& path : pathPool_) {
-        const auto& orders = path->orders();
+    for (size_t pathId = 0; pathId < pathPool_.size(); ++pathId) {
+        const auto& orders = pathPool_.cold(pathId).orders;
         std::string pathStr;
         for (size_t i = 0; i < orders.size(); ++i) {
             if (i > 0) pathStr += " -> ";
@@ -59,212 +174,379 @@ void TriangularArbitrage::discoverRoutes(const std::vector<fin::Symbol>& symbols
             pathStr += (orders[i].getWay() == Way::BUY) ? " (BUY)" : " (SELL)";
         }
         LOG_INFO("[TriangularArbitrage] Path {:>4}: {}", pathId, pathStr);
-        ++pathId;
     }
     LOG_INFO("[TriangularArbitrage] ======================================");
 }
 
-std::vector<Order> TriangularArbitrage::getPossibleOrders(
-    const std::string& coin,
-    const std::vector<fin::Symbol>& relatedSymbols)
-{
-    std::vector<Order> orders;
-    for (const auto& symbol : relatedSymbols) {
-        if (coin == symbol.getBase()) {
-            orders.emplace_back(symbol, Way::SELL);
-        } else if (coin == symbol.getQuote()) {
-            orders.emplace_back(symbol, Way::BUY);
-        }
-    }
-    return orders;
-}
-
-std::vector<ArbitragePath> TriangularArbitrage::computeArbitragePaths(
+std::vector<RouteDescriptor> TriangularArbitrage::computeArbitragePaths(
     const std::vector<fin::Symbol>& symbolsList,
-    const std::string& startingAsset,
-    int arbitrageDepth)
+    const std::string& startingAsset) const
 {
     LOG_INFO("[TriangularArbitrage] Computing arbitrage paths...");
-    std::vector<std::vector<Order>> stratPaths;
-    auto firstOrders = getPossibleOrders(startingAsset, symbolsList);
-
-    for (const auto& order : firstOrders) {
-        stratPaths.push_back({order});
-    }
-
-    for (int i = 0; i < arbitrageDepth - 1; ++i) {
-        std::vector<std::vector<Order>> paths;
-        for (const auto& path : stratPaths) {
-            Order lastOrder = path.back();
-            std::string resultingCoin = (lastOrder.getWay() == Way::SELL)
-                ? lastOrder.getSymbol().getQuote()
-                : lastOrder.getSymbol().getBase();
-
-            std::vector<fin::Symbol> unusedSymbols;
-            for (const auto& symbol : symbolsList) {
-                bool used = std::any_of(path.begin(), path.end(),
-                    [&symbol](const Order& order) { return order.getSymbol() == symbol; });
-                if (!used) {
-                    unusedSymbols.push_back(symbol);
-                }
-            }
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Integer asset ids
+    std::unordered_map<std::string, uint32_t> assetIds;
+    std::vector<std::pair<uint32_t, uint32_t>> symbolAssets;  // (base, quote)
+    symbolAssets.reserve(symbolsList.size());
+    for (const auto& symbol : symbolsList) {
+        const uint32_t base = assetIds.emplace(symbol.getBase(), static_cast<uint32_t>(assetIds.size())).first->second;
+        const uint32_t quote = assetIds.emplace(symbol.getQuote(), static_cast<uint32_t>(assetIds.size())).first->second;
+        symbolAssets.emplace_back(base, quote);
+    }
 
-            std::vector<Order> possibleNextOrders = getPossibleOrders(resultingCoin, unusedSymbols);
-            for (const auto& nextOrder : possibleNextOrders) {
-                std::string nextResultingCoin = (nextOrder.getWay() == Way::SELL)
-                    ? nextOrder.getSymbol().getQuote()
-                    : nextOrder.getSymbol().getBase();
+    const auto startIt = assetIds.find(startingAsset);
+    if (startIt == assetIds.end()) {
+        LOG_WARNING("[TriangularArbitrage] Starting asset {} not found in any symbol", startingAsset);
+        return {};
+    }
+    const uint32_t start = startIt->second;
+
+    // CSR adjacency, filled in symbol order so routes come out in the same
+    // order as a scan of the symbol list
+    AssetAdjacency adjacency;
+    adjacency.offsets.assign(assetIds.size() + 1, 0);
+    for (const auto& [base, quote] : symbolAssets) {
+        ++adjacency.offsets[base + 1];
+        ++adjacency.offsets[quote + 1];
+    }
+    for (size_t a = 0; a < assetIds.size(); ++a) {
+        adjacency.offsets[a + 1] += adjacency.offsets[a];
+    }
+    adjacency.legs.resize(adjacency.offsets.back());
+    std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (uint32_t i = 0; i < symbolAssets.size(); ++i) {
+        const auto [base, quote] = symbolAssets[i];
+        adjacency.legs[cursor[base]++] = {i, quote, false};
+        adjacency.legs[cursor[quote]++] = {i, base, true};
+    }
 
-                if ((i == arbitrageDepth - 2) && (nextResultingCoin != startingAsset)) {
+    // start -> a1 -> a2 -> start, each symbol used once
+    auto expand = [&](const AssetAdjacency::Leg* first, const AssetAdjacency::Leg* last,
+                      std::vector<RouteDescriptor>& out) {
+        for (const auto* l1 = first; l1 != last; ++l1) {
+            for (const auto* l2 = adjacency.begin(l1->to); l2 != adjacency.end(l1->to); ++l2) {
+                if (l2->symbol == l1->symbol) {
                     continue;
                 }
-
-                auto newPath = path;
-                newPath.push_back(nextOrder);
-                paths.push_back(newPath);
+                for (const auto* l3 = adjacency.begin(l2->to); l3 != adjacency.end(l2->to); ++l3) {
+                    if (l3->to != start || l3->symbol == l1->symbol || l3->symbol == l2->symbol) {
+                        continue;
+                    }
+                    out.push_back({{l1->symbol, l2->symbol, l3->symbol},
+                                   {l1->isBuy, l2->isBuy, l3->isBuy}});
+                }
             }
         }
-        stratPaths = paths;
-    }
+    };
 
-    std::vector<ArbitragePath> resultPaths;
-    resultPaths.reserve(stratPaths.size());
+    const auto* firstBegin = adjacency.begin(start);
+    const size_t firstCount = adjacency.end(start) - firstBegin;
+
+    const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t workers = std::clamp<size_t>(firstCount / MIN_FIRST_LEGS_PER_THREAD, 1, hardware);
+
+    std::vector<std::vector<RouteDescriptor>> partial(workers);
+    if (workers == 1) {
+        expand(firstBegin, firstBegin + firstCount, partial[0]);
+    } else {
+        // Contiguous chunks of first legs keep the concatenation in order
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        const size_t chunk = (firstCount + workers - 1) / workers;
+        for (size_t w = 0; w < workers; ++w) {
+            const size_t lo = std::min(firstCount, w * chunk);
+            const size_t hi = std::min(firstCount, lo + chunk);
+            threads.emplace_back(expand, firstBegin + lo, firstBegin + hi, std::ref(partial[w]));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
 
-    for (auto& path : stratPaths) {
-        resultPaths.emplace_back(std::move(path), feeFunction_);
+    size_t total = 0;
+    for (const auto& routes : partial) {
+        total += routes.size();
+    }
+    std::vector<RouteDescriptor> routes;
+    routes.reserve(total);
+    for (const auto& chunkRoutes : partial) {
+        routes.insert(routes.end(), chunkRoutes.begin(), chunkRoutes.end());
     }
 
-    LOG_INFO("[TriangularArbitrage] Created {} arbitrage paths of depth {} from asset {}",
-             resultPaths.size(), arbitrageDepth, startingAsset);
-    return resultPaths;
+    const auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    LOG_INFO("[TriangularArbitrage] Created {} arbitrage paths of depth 3 from asset {} ({} first legs, {} thread(s), {}us)",
+             routes.size(), startingAsset, firstCount, workers, elapsedUs);
+    return routes;
 }
 
 std::optional<Signal> TriangularArbitrage::onMarketDataUpdate(
-    const std::bitset<MAX_SYMBOLS>& updatedSymbols,
+    const UpdateMask& updatedSymbols,
     const OrderBook& orderBook,
     double stake,
     const OrderSizer& sizer)
 {
+    // Keep the graph current even when there is nothing to trade
+    if (cycleEngine_) {
+        cycleEngine_->onUpdates(updatedSymbols, orderBook);
+    }
+
+    if (stake <= 0) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    auto signal = detectPaths(updatedSymbols, orderBook, stake, sizer);
+    return cycleEngine_ ? withCycles(std::move(signal), orderBook, stake, sizer) : signal;
+}
+
+std::optional<Signal> TriangularArbitrage::onSymbolUpdate(
+    SymbolId symbolId,
+    const OrderBook& orderBook,
+    double stake,
+    const OrderSizer& sizer)
+{
+    if (cycleEngine_) {
+        cycleEngine_->onSymbolUpdate(symbolId, orderBook);
+    }
+
     if (stake <= 0) [[unlikely]] {
         return std::nullopt;
     }
 
+    auto signal = detectPathsForSymbol(symbolId, orderBook, stake, sizer);
+    return cycleEngine_ ? withCycles(std::move(signal), orderBook, stake, sizer) : signal;
+}
+
+std::optional<Signal> TriangularArbitrage::withCycles(
+    std::optional<Signal> pathSignal,
+    const OrderBook& orderBook,
+    double stake,
+    const OrderSizer& sizer)
+{
+    auto cycleSignal = cycleEngine_->findSignal(minProfitRatio_, stake, orderBook, sizer);
+    if (!cycleSignal.has_value()) [[likely]] {
+        return pathSignal;
+    }
+
+    if (pathSignal.has_value() && pathSignal->pnl >= cycleSignal->pnl) {
+        return pathSignal;
+    }
+
+    LOG_CRITICAL("[TriangularArbitrage] Found {}-leg cycle: {} with pnl={:.8f}",
+                 cycleSignal->orders.size(), cycleSignal->description, cycleSignal->pnl);
+    return cycleSignal;
+}
+
+std::optional<Signal> TriangularArbitrage::detectPaths(
+    const UpdateMask& updatedSymbols,
+    const OrderBook& orderBook,
+    double stake,
+    const OrderSizer& sizer)
+{
     if (pathPool_.size() == 0) [[unlikely]] {
         return std::nullopt;
     }
 
+    if (detectionMode_ == DetectionMode::BreakEven) {
+        breakEvenIndex_.onUpdates(updatedSymbols, orderBook, screenCandidates_);
+        if (screenCandidates_.empty()) [[likely]] {
+            return std::nullopt;
+        }
+        return evaluatePaths(screenCandidates_, orderBook, stake, sizer);
+    }
+
+    if (detectionMode_ == DetectionMode::LogScore) {
+        auto& scores = pathPool_.scores();
+        scores.onUpdates(updatedSymbols, orderBook);
+        scores.collect(minProfitRatio_, screenCandidates_);
+        if (screenCandidates_.empty()) [[likely]] {
+            return std::nullopt;
+        }
+        return evaluatePaths(screenCandidates_, orderBook, stake, sizer);
+    }
+
     // Get affected paths using inverted index - O(U) where U = updated symbols
-    auto affectedPathIndices = pathPool_.getAffectedPaths(updatedSymbols);
+    const auto affectedPathIndices = pathPool_.getAffectedPaths(updatedSymbols);
 
     if (affectedPathIndices.empty()) [[likely]] {
         return std::nullopt;
     }
 
+    if (affectedPathIndices.size() * FULL_SCREEN_DIVISOR >= pathPool_.size()) {
+        pathPool_.screenAll(orderBook, minProfitRatio_, screenCandidates_);
+        if (screenCandidates_.empty()) [[likely]] {
+            return std::nullopt;
+        }
+        return evaluatePaths(screenCandidates_, orderBook, stake, sizer);
+    }
+
+    return evaluatePaths(affectedPathIndices, orderBook, stake, sizer);
+}
+
+std::optional<Signal> TriangularArbitrage::detectPathsForSymbol(
+    SymbolId symbolId,
+    const OrderBook& orderBook,
+    double stake,
+    const OrderSizer& sizer)
+{
+    if (detectionMode_ == DetectionMode::BreakEven) {
+        breakEvenIndex_.onSymbolUpdate(symbolId, orderBook, screenCandidates_);
+        if (screenCandidates_.empty()) [[likely]] {
+            return std::nullopt;
+        }
+        return evaluatePaths(screenCandidates_, orderBook, stake, sizer);
+    }
+
+    if (detectionMode_ == DetectionMode::LogScore) {
+        auto& scores = pathPool_.scores();
+        scores.onSymbolUpdate(symbolId, orderBook);
+        scores.collect(minProfitRatio_, screenCandidates_);
+        if (screenCandidates_.empty()) [[likely]] {
+            return std::nullopt;
+        }
+        return evaluatePaths(screenCandidates_, orderBook, stake, sizer);
+    }
+
+    // Only the paths containing the leg that moved
+    const auto pathIndices = pathPool_.pathsForSymbol(symbolId);
+
+    if (pathIndices.empty()) [[likely]] {
+        return std::nullopt;
+    }
+
+    return evaluatePaths(pathIndices, orderBook, stake, sizer);
+}
+
+void TriangularArbitrage::logPathTrace(uint32_t pathIdx, const PathQuotes& quotes, double feeRate) const {
+    // Debug: Log detailed fast ratio computation like user's notes
+    const PathRecord& record = pathPool_.record(pathIdx);
+    const auto& orders = pathPool_.cold(pathIdx).orders;
+    const auto& bids = quotes.bids;
+    const auto& asks = quotes.asks;
+    std::array<std::string, 3> syms;
+    for (size_t leg = 0; leg < 3; ++leg) {
+        syms[leg] = orders[leg].getSymbol().to_str();
+    }
+
+    LOG_DEBUG("[Eval] Path {:>4} FEE_RATE = {}", pathIdx, feeRate);
+    LOG_DEBUG("[Eval] Path {:>4} MD : {} [b={:.8f} a={:.8f}], {} [b={:.8f} a={:.8f}], {} [b={:.8f} a={:.8f}]",
+             pathIdx,
+             syms[0], bids[0], asks[0],
+             syms[1], bids[1], asks[1],
+             syms[2], bids[2], asks[2]);
+
+    // Compute theoretical path step by step (no rounding, just for logging)
+    double currentAmount = 1.0;  // Start with 1 unit
+    for (size_t leg = 0; leg < 3; ++leg) {
+        const auto& order = orders[leg];
+        std::string giveAsset = order.getStartingAsset();
+        std::string getAsset = order.getResultingAsset();
+        double startQty = currentAmount;
+
+        if (record.isBuy(leg)) {
+            // BUY: give quote, get base = startQty / ask, fee on get
+            double rawGet = startQty / asks[leg];
+            double fee = rawGet * feeRate;
+            double endQty = rawGet - fee;
+
+            if (leg == 0) {
+                LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=balance[{}]={}}} {}, "
+                         "get {{startingQty_{}[{}] / ask[{}] = {} / {} = {}}} {}, "
+                         "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
+                         pathIdx, "BUY", syms[leg],
+                         leg + 1, giveAsset, giveAsset, startQty, giveAsset,
+                         leg + 1, giveAsset, syms[leg], startQty, asks[leg], rawGet, getAsset,
+                         rawGet, feeRate, fee,
+                         leg + 1, getAsset, endQty);
+            } else {
+                LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=endingQty_{}[{}]={}}} {}, "
+                         "get {{startingQty_{}[{}] / ask[{}] = {} / {} = {}}} {}, "
+                         "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
+                         pathIdx, "BUY", syms[leg],
+                         leg + 1, giveAsset, leg, giveAsset, startQty, giveAsset,
+                         leg + 1, giveAsset, syms[leg], startQty, asks[leg], rawGet, getAsset,
+                         rawGet, feeRate, fee,
+                         leg + 1, getAsset, endQty);
+            }
+            currentAmount = endQty;
+        } else {
+            // SELL: give base, get quote = startQty * bid, fee on get
+            double rawGet = startQty * bids[leg];
+            double fee = rawGet * feeRate;
+            double endQty = rawGet - fee;
+
+            if (leg == 0) {
+                LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=balance[{}]={}}} {}, "
+                         "get {{startingQty_{}[{}] * bid[{}] = {} * {} = {}}} {}, "
+                         "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
+                         pathIdx, "SELL", syms[leg],
+                         leg + 1, giveAsset, giveAsset, startQty, giveAsset,
+                         leg + 1, giveAsset, syms[leg], startQty, bids[leg], rawGet, getAsset,
+                         rawGet, feeRate, fee,
+                         leg + 1, getAsset, endQty);
+            } else {
+                LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=endingQty_{}[{}]={}}} {}, "
+                         "get {{startingQty_{}[{}] * bid[{}] = {} * {} = {}}} {}, "
+                         "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
+                         pathIdx, "SELL", syms[leg],
+                         leg + 1, giveAsset, leg, giveAsset, startQty, giveAsset,
+                         leg + 1, giveAsset, syms[leg], startQty, bids[leg], rawGet, getAsset,
+                         rawGet, feeRate, fee,
+                         leg + 1, getAsset, endQty);
+            }
+            currentAmount = endQty;
+        }
+    }
+
+    double theoreticalPnl = currentAmount - 1.0;
+    double theoreticalPnlPct = theoreticalPnl * 100.0;
+    LOG_DEBUG("[Eval] Path {:>4} PNL = {} - 1 = {}/1 = {}%",
+             pathIdx, currentAmount, theoreticalPnl, theoreticalPnlPct);
+}
+
+std::optional<Signal> TriangularArbitrage::evaluatePaths(
+    std::span<const uint32_t> pathIndices,
+    const OrderBook& orderBook,
+    double stake,
+    const OrderSizer& sizer)
+{
     std::optional<Signal> bestSignal;
     double bestPnl = 0.0;
 
     // Fee rate as decimal (e.g., 0.001 for 0.1%)
     const double feeRate = defaultFee_ / 100.0;
 
-    for (size_t pathIdx : affectedPathIndices) {
-        auto& path = pathPool_.getPath(pathIdx);
-
-        // Update prices from lock-free book
-        path->updatePrices(orderBook);
+    PathQuotes quotes;
 
-        // Fast screen
-        double ratio = path->getFastRatio();
+    for (uint32_t pathIdx : pathIndices) {
+        // Read prices from lock-free book, fast screen
+        double ratio = pathPool_.refresh(pathIdx, orderBook, quotes);
 
         if (ratio <= minProfitRatio_) [[likely]] {
             continue;
         }
 
-        // Debug: Log detailed fast ratio computation like user's notes
-        const auto& syms = path->symbols();
-        const auto& bids = path->cachedBids();
-        const auto& asks = path->cachedAsks();
-        const auto& dirs = path->legDirections();
-        const auto& orders = path->orders();
-
-        LOG_DEBUG("[Eval] Path {:>4} FEE_RATE = {}", pathIdx, feeRate);
-        LOG_DEBUG("[Eval] Path {:>4} MD : {} [b={:.8f} a={:.8f}], {} [b={:.8f} a={:.8f}], {} [b={:.8f} a={:.8f}]",
-                 pathIdx,
-                 syms[0], bids[0], asks[0],
-                 syms[1], bids[1], asks[1],
-                 syms[2], bids[2], asks[2]);
-
-        // Compute theoretical path step by step (no rounding, just for logging)
-        double currentAmount = 1.0;  // Start with 1 unit
-        for (size_t leg = 0; leg < 3; ++leg) {
-            const auto& order = orders[leg];
-            std::string giveAsset = order.getStartingAsset();
-            std::string getAsset = order.getResultingAsset();
-            double startQty = currentAmount;
-
-            if (dirs[leg]) {
-                // BUY: give quote, get base = startQty / ask, fee on get
-                double rawGet = startQty / asks[leg];
-                double fee = rawGet * feeRate;
-                double endQty = rawGet - fee;
-
-                if (leg == 0) {
-                    LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=balance[{}]={}}} {}, "
-                             "get {{startingQty_{}[{}] / ask[{}] = {} / {} = {}}} {}, "
-                             "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
-                             pathIdx, "BUY", syms[leg],
-                             leg + 1, giveAsset, giveAsset, startQty, giveAsset,
-                             leg + 1, giveAsset, syms[leg], startQty, asks[leg], rawGet, getAsset,
-                             rawGet, feeRate, fee,
-                             leg + 1, getAsset, endQty);
-                } else {
-                    LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=endingQty_{}[{}]={}}} {}, "
-                             "get {{startingQty_{}[{}] / ask[{}] = {} / {} = {}}} {}, "
-                             "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
-                             pathIdx, "BUY", syms[leg],
-                             leg + 1, giveAsset, leg, giveAsset, startQty, giveAsset,
-                             leg + 1, giveAsset, syms[leg], startQty, asks[leg], rawGet, getAsset,
-                             rawGet, feeRate, fee,
-                             leg + 1, getAsset, endQty);
-                }
-                currentAmount = endQty;
-            } else {
-                // SELL: give base, get quote = startQty * bid, fee on get
-                double rawGet = startQty * bids[leg];
-                double fee = rawGet * feeRate;
-                double endQty = rawGet - fee;
-
-                if (leg == 0) {
-                    LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=balance[{}]={}}} {}, "
-                             "get {{startingQty_{}[{}] * bid[{}] = {} * {} = {}}} {}, "
-                             "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
-                             pathIdx, "SELL", syms[leg],
-                             leg + 1, giveAsset, giveAsset, startQty, giveAsset,
-                             leg + 1, giveAsset, syms[leg], startQty, bids[leg], rawGet, getAsset,
-                             rawGet, feeRate, fee,
-                             leg + 1, getAsset, endQty);
-                } else {
-                    LOG_DEBUG("[Eval] Path {:>4} {}@{} give {{startingQty_{}[{}]=endingQty_{}[{}]={}}} {}, "
-                             "get {{startingQty_{}[{}] * bid[{}] = {} * {} = {}}} {}, "
-                             "pay fee {{{} * {} = {}}}, endingQty_{}[{}]={}",
-                             pathIdx, "SELL", syms[leg],
-                             leg + 1, giveAsset, leg, giveAsset, startQty, giveAsset,
-                             leg + 1, giveAsset, syms[leg], startQty, bids[leg], rawGet, getAsset,
-                             rawGet, feeRate, fee,
-                             leg + 1, getAsset, endQty);
-                }
-                currentAmount = endQty;
-            }
-        }
-
-        double theoreticalPnl = currentAmount - 1.0;
-        double theoreticalPnlPct = theoreticalPnl * 100.0;
-        LOG_DEBUG("[Eval] Path {:>4} PNL = {} - 1 = {}/1 = {}%",
-                 pathIdx, currentAmount, theoreticalPnl, theoreticalPnlPct);
+        // Full evaluation with actual stake and rounding (VWAP when depth is available)
+        auto signal = depthBook_
+            ? pathPool_.evaluateVwap(pathIdx, stake, *depthBook_, sizer)
+            : pathPool_.evaluate(pathIdx, quotes, stake);
 
-        // Full evaluation with actual stake and rounding
-        auto signal = path->evaluate(stake, orderBook, sizer, feeFunction_);
+        if (signal.has_value()) [[unlikely]] {
+            logPathTrace(pathIdx, quotes, feeRate);
+        }
 
         if (signal.has_value() && signal->pnl > bestPnl) [[unlikely]] {
+            // A leg outside its NOTIONAL bounds would be rejected mid-cycle
+            const PathRecord& record = pathPool_.record(pathIdx);
+            std::array<LegSize, 3> legs;
+            for (size_t leg = 0; leg < 3; ++leg) {
+                legs[leg] = {record.ids[leg], signal->orders[leg].getPrice(), signal->orders[leg].getQty()};
+            }
+            if (!sizer.validateNotionals(legs, true)) {
+                LOG_DEBUG("[Eval] Path {:>4} rejected: a leg fails the notional filter", pathIdx);
+                continue;
+            }
             bestPnl = signal->pnl;
             bestSignal = std::move(signal);
         }
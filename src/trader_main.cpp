@@ -4,26 +4,32 @@
 #include <getopt.h>
 
 void printUsage(const std::string& programName) {
-    std::cout << "Usage: " << programName << " --config <path_to_ini>" << std::endl;
+    std::cout << "Usage: " << programName << " --config <path_to_ini> [--replay <journal>]" << std::endl;
     std::cout << "       --config, -c : Path to the configuration INI file." << std::endl;
+    std::cout << "       --replay, -r : Replay a recorded market data journal instead of connecting (overrides REPLAY.journal)." << std::endl;
 }
 
 int main(int argc, char* argv[]) {
     std::string configFile;
+    std::string replayJournal;
 
     static struct option long_options[] = {
         {"config", required_argument, 0, 'c'},
+        {"replay", required_argument, 0, 'r'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}
     };
 
     int option_index = 0;
     int c;
-    while ((c = getopt_long(argc, argv, "c:h", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "c:r:h", long_options, &option_index)) != -1) {
         switch (c) {
             case 'c':
                 configFile = optarg;
                 break;
+            case 'r':
+                replayJournal = optarg;
+                break;
             case 'h':
                 printUsage(argv[0]);
                 return 0;
@@ -42,6 +48,9 @@ int main(int argc, char* argv[]) {
 
     try {
         auto config = Runner::loadConfig(configFile);
+        if (!replayJournal.empty()) {
+            config.replayJournal = replayJournal;
+        }
         Runner runner(config);
         runner.initialize();
         runner.run();